@@ -0,0 +1,167 @@
+#include "algo.h"
+#include "deque.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+using namespace mystl;
+
+// 自定义的连续迭代器 (类似 span 的迭代器), steps 统计逐个前进、后退的次数,
+// 走 memmove / memset 的路径时不应逐个移动
+static long steps = 0;
+
+template <class T>
+struct span_iter : public mystl::iterator<mystl::contiguous_iterator_tag, T> {
+    T *p;
+
+    span_iter() : p(nullptr) {}
+    explicit span_iter(T *x) : p(x) {}
+
+    T& operator*()  const { return *p; }
+    T* operator->() const { return p; }
+    T& operator[](ptrdiff_t n) const { return p[n]; }
+
+    span_iter& operator++() { ++steps; ++p; return *this; }
+    span_iter& operator--() { ++steps; --p; return *this; }
+    span_iter  operator++(int) { span_iter tmp = *this; ++*this; return tmp; }
+    span_iter  operator--(int) { span_iter tmp = *this; --*this; return tmp; }
+
+    span_iter& operator+=(ptrdiff_t n) { p += n; return *this; }
+    span_iter& operator-=(ptrdiff_t n) { p -= n; return *this; }
+    span_iter  operator+(ptrdiff_t n) const { return span_iter(p + n); }
+    span_iter  operator-(ptrdiff_t n) const { return span_iter(p - n); }
+    ptrdiff_t  operator-(const span_iter &rhs) const { return p - rhs.p; }
+
+    bool operator==(const span_iter &rhs) const { return p == rhs.p; }
+    bool operator!=(const span_iter &rhs) const { return p != rhs.p; }
+    bool operator<(const span_iter &rhs)  const { return p < rhs.p; }
+};
+
+// 复制到第 copies_left 次时抛出异常, 用 live 检查构造失败后没有留下元素
+static int copies_left = -1;
+
+struct counted {
+    static int live;
+    int v;
+    counted(int x) : v(x) { ++live; }
+    counted(const counted &rhs) : v(rhs.v)
+    {
+        if (copies_left == 0)
+            throw std::runtime_error("copy");
+        if (copies_left > 0)
+            --copies_left;
+        ++live;
+    }
+    ~counted() { --live; }
+    bool operator<(const counted &rhs) const { return v < rhs.v; }
+};
+int counted::live = 0;
+
+int main()
+{
+    // 与 std 的结果对照, 含重复元素、空区间和超出两端的查找值
+    for (int n = 0; n < 200; ++n) {
+        std::vector<int> v(n);
+        for (int i = 0; i < n; ++i)
+            v[i] = 2 * i + std::rand() % 2;
+        std::sort(v.begin(), v.end());
+        deque<int> d(v.data(), v.data() + n);
+        eytzinger_index<int> e(v.data(), v.data() + n);
+
+        for (int k = -2; k < 2 * n + 3; ++k) {
+            const long lb = std::lower_bound(v.begin(), v.end(), k) - v.begin();
+            const long ub = std::upper_bound(v.begin(), v.end(), k) - v.begin();
+            assert(mystl::lower_bound(v.data(), v.data() + n, k) - v.data() == lb);
+            assert(mystl::lower_bound(d.begin(), d.end(), k) - d.begin() == lb);
+            assert(mystl::upper_bound(v.data(), v.data() + n, k) - v.data() == ub);
+            assert(mystl::upper_bound(d.begin(), d.end(), k) - d.begin() == ub);
+            assert(mystl::binary_search(v.data(), v.data() + n, k) ==
+                   std::binary_search(v.begin(), v.end(), k));
+            const int *p = e.lower_bound(k);
+            assert(lb == n ? p == nullptr : (p != nullptr && *p == v[lb]));
+        }
+    }
+
+    // eytzinger_index 构造或复制中途抛出异常时, 已构造的元素全部析构
+    {
+        std::vector<counted> v;
+        for (int i = 0; i < 100; ++i)
+            v.push_back(counted(i));
+        const int live = counted::live;
+        for (int fail = 0; fail < 100; fail += 7) {
+            copies_left = fail;
+            try {
+                eytzinger_index<counted> e(v.data(), v.data() + v.size());
+                assert(false);
+            }
+            catch (const std::runtime_error&) {
+            }
+            assert(counted::live == live);
+        }
+        copies_left = -1;
+        eytzinger_index<counted> e(v.data(), v.data() + v.size());
+        copies_left = 50;
+        try {
+            eytzinger_index<counted> c(e);
+            assert(false);
+        }
+        catch (const std::runtime_error&) {
+        }
+        copies_left = -1;
+        assert(counted::live == live + 100);
+        assert(e.lower_bound(counted(42))->v == 42);
+    }
+
+    // 自定义连续迭代器经 to_address 走 memmove / memset, 反向迭代器不再是连续的
+    {
+        typedef span_iter<int>  it;
+        typedef span_iter<char> cit;
+        static_assert(is_contiguous_iterator<it>::value, "");
+        static_assert(!is_contiguous_iterator<mystl::reverse_iterator<it>>::value, "");
+        static_assert(__is_memcpy_copyable<it, it>::value, "");
+        static_assert(__is_memcpy_copyable<const int*, it>::value, "");
+        static_assert(__is_memcpy_movable<it, int*>::value, "");
+        static_assert(__is_memset_fillable<cit, char>::value, "");
+        static_assert(!__is_memcpy_copyable<it, span_iter<long>>::value, "");
+
+        int a[100], b[100];
+        for (int i = 0; i < 100; ++i) {
+            a[i] = i;
+            b[i] = -1;
+        }
+        assert(mystl::to_address(it(a + 3)) == a + 3);
+
+        steps = 0;
+        it r = mystl::copy(it(a), it(a + 100), it(b));
+        assert(r == it(b + 100) && b[0] == 0 && b[99] == 99);
+        r = mystl::copy_backward(it(a), it(a + 50), it(b + 100));
+        assert(r == it(b + 50) && b[50] == 0 && b[99] == 49);
+        r = mystl::move(it(a + 10), it(a + 20), it(b));
+        assert(r == it(b + 10) && b[0] == 10 && b[9] == 19);
+        int *q = mystl::copy(it(a), it(a + 5), b + 95);
+        assert(q == b + 100 && b[95] == 0 && b[99] == 4);
+
+        char c[64];
+        cit cr = mystl::fill_n(cit(c), 64, 'x');
+        assert(cr == cit(c + 64) && c[0] == 'x' && c[63] == 'x');
+
+        alignas(int) unsigned char raw[sizeof(a)];
+        int *u = reinterpret_cast<int*>(raw);
+        it ur = mystl::uninitialized_copy(it(a), it(a + 100), it(u));
+        assert(ur == it(u + 100) && u[42] == 42);
+        assert(steps == 0);
+
+        // 非平凡类型仍逐个复制
+        std::string s[3] = {"a", "b", "c"}, t[3];
+        mystl::copy(span_iter<std::string>(s), span_iter<std::string>(s + 3),
+                    span_iter<std::string>(t));
+        assert(t[2] == "c" && steps > 0);
+    }
+
+    std::cout << "algo ok" << std::endl;
+    return 0;
+}
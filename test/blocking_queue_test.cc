@@ -0,0 +1,74 @@
+#include "blocking_queue.h"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace mystl;
+
+int main()
+{
+    // 满/空时的非阻塞操作, 环形下标回绕, 关闭后的行为
+    {
+        bounded_blocking_queue<std::string> q(3);
+        assert(q.push(std::string(40, 'a')) && q.try_push(std::string("b")));
+        std::string s;
+        assert(q.try_pop(s) && s == std::string(40, 'a'));
+        assert(q.push("c") && q.push("d"));
+        assert(!q.try_push(std::string("e")) && q.size() == 3);
+        q.close();
+        assert(q.closed() && !q.push("f"));
+        std::string out[4];
+        assert(q.pop_up_to(out, 4) == 3 && out[0] == "b" && out[2] == "d");
+        assert(!q.pop(s) && q.pop_up_to(out, 4) == 0);
+    }
+
+    // 多生产者、多消费者, 容量远小于元素总数, 生产者全部结束后关闭
+    {
+        bounded_blocking_queue<long> q(64);
+        const long n = 50000;
+        const int producers = 3, consumers = 3;
+        std::atomic<long> sum(0), count(0);
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&q, n] {
+                long b[10];
+                for (long i = 0; i < n;) {
+                    if (i % 2 == 0 && i + 10 <= n) {
+                        for (int k = 0; k < 10; ++k)
+                            b[k] = i + k;
+                        assert(q.push_n(b, 10) == 10);
+                        i += 10;
+                    }
+                    else {
+                        assert(q.push(i++));
+                    }
+                }
+            });
+        }
+        for (int c = 0; c < consumers; ++c) {
+            threads.emplace_back([&, c] {
+                long out[16];
+                for (;;) {
+                    const size_t m = (c % 2) ? q.pop_up_to(out, 16) : (q.pop(out[0]) ? 1 : 0);
+                    if (m == 0)
+                        break;
+                    for (size_t k = 0; k < m; ++k)
+                        sum += out[k];
+                    count += static_cast<long>(m);
+                }
+            });
+        }
+        for (int p = 0; p < producers; ++p)
+            threads[p].join();
+        q.close();
+        for (int c = 0; c < consumers; ++c)
+            threads[producers + c].join();
+        assert(count.load() == n * producers);
+        assert(sum.load() == producers * (n * (n - 1) / 2));
+    }
+
+    std::cout << "blocking_queue ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,103 @@
+// concurrent_queue 与加锁 deque 在 1..N 个生产者、消费者下的吞吐量
+// 编译: g++ -std=c++11 -O2 -Itinystl test/concurrent_queue_bench.cc -pthread
+// 参数: 每个生产者发送的元素个数 (默认 1000000), 最大线程数 N (默认为硬件线程数)
+
+#include "concurrent_queue.h"
+#include "deque.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace mystl;
+
+typedef std::chrono::steady_clock clock_type;
+
+// 用互斥锁保护的 deque, 提供与 concurrent_queue 相同的 push/try_pop
+class locked_deque {
+public:
+    void push(long v)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        d_.push_back(v);
+    }
+    bool try_pop(long &out)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (d_.empty())
+            return false;
+        out = d_.front();
+        d_.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex  mutex_;
+    deque<long> d_;
+};
+
+// producers 个线程各发送 n 个数, consumers 个线程取出全部元素, 返回每秒传递的元素个数
+template <class Queue>
+double throughput(int producers, int consumers, long n)
+{
+    Queue q;
+    const long total = n * producers;
+    std::atomic<long> taken(0), sum(0);
+    std::vector<std::thread> threads;
+
+    const auto start = clock_type::now();
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&q, n] {
+            for (long i = 0; i < n; ++i)
+                q.push(i);
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            long v = 0, local = 0, got = 0;
+            while (taken.load(std::memory_order_relaxed) < total) {
+                if (q.try_pop(v)) {
+                    local += v;
+                    ++got;
+                    if ((got & 255) == 0) {
+                        taken.fetch_add(got);
+                        got = 0;
+                    }
+                }
+                else {
+                    // 队列为空时把已取出的个数计入, 并让出处理器, 单核机器上也能运行
+                    taken.fetch_add(got);
+                    got = 0;
+                    std::this_thread::yield();
+                }
+            }
+            taken.fetch_add(got);
+            sum.fetch_add(local);
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+    const double sec = std::chrono::duration<double>(clock_type::now() - start).count();
+    if (sum.load() != producers * (n * (n - 1) / 2))
+        std::printf("bad sum\n");
+    return total / sec;
+}
+
+int main(int argc, char **argv)
+{
+    const long n = argc > 1 ? std::atol(argv[1]) : 1000000;
+    int max_threads = argc > 2 ? std::atoi(argv[2])
+                               : static_cast<int>(std::thread::hardware_concurrency());
+    if (max_threads < 1)
+        max_threads = 1;
+
+    std::printf("%4s %4s %18s %18s\n", "prod", "cons", "concurrent_queue", "locked deque");
+    for (int k = 1; k <= max_threads; k *= 2) {
+        const double a = throughput<concurrent_queue<long>>(k, k, n);
+        const double b = throughput<locked_deque>(k, k, n);
+        std::printf("%4d %4d %14.1f M/s %14.1f M/s\n", k, k, a / 1e6, b / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "concurrent_queue.h"
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace mystl;
+
+// 未释放的内存块个数, 用于检查已完成的段被回收
+static std::atomic<long> live_allocs(0);
+
+void* operator new(size_t n)
+{
+    void *p = std::malloc(n == 0 ? 1 : n);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    ++live_allocs;
+    return p;
+}
+
+// 与上面的 operator new 配对, GCC 无法看出两者匹配
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *p) noexcept
+{
+    if (p != nullptr)
+        --live_allocs;
+    std::free(p);
+}
+void operator delete(void *p, size_t) noexcept { operator delete(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// 解引用到 fail 时抛出异常的输入迭代器
+struct failing_iter {
+    const long *p;
+    const long *fail;
+    long operator*() const
+    {
+        if (p == fail)
+            throw std::runtime_error("deref");
+        return *p;
+    }
+    failing_iter& operator++() { ++p; return *this; }
+};
+
+int main()
+{
+    // 单线程下保持先进先出, 跨越多个段
+    {
+        concurrent_queue<std::string> q;
+        for (int i = 0; i < 1000; ++i)
+            q.push(std::to_string(i));
+        std::string b[3] = {"a", "b", "c"};
+        q.push_n(b, 3);
+        std::string s;
+        for (int i = 0; i < 1000; ++i) {
+            assert(q.try_pop(s));
+            assert(s == std::to_string(i));
+        }
+        std::string out[8];
+        assert(q.try_pop_n(out, 8) == 3 && out[0] == "a" && out[2] == "c");
+        assert(!q.try_pop(s));
+        for (int i = 0; i < 500; ++i)
+            q.push(std::string(40, 'x'));   // 析构时销毁剩余元素
+    }
+
+    // push_n 中途解引用失败: 已放入的元素保留, 其余序号全部作废, 所在的段仍能回收
+    {
+        concurrent_queue<long> q;
+        const long b[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+        bool threw = false;
+        try {
+            q.push_n(failing_iter{b, b + 3}, 8);
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+        long v = -1;
+        for (long i = 0; i < 3; ++i) {
+            const bool got = q.try_pop(v);
+            assert(got && v == i);
+        }
+        const bool got = q.try_pop(v);
+        assert(!got);
+
+        const long base = live_allocs.load();
+        const long seg = static_cast<long>(concurrent_queue<long>::segment_size);
+        for (long r = 0; r < 64; ++r) {
+            for (long i = 0; i < seg; ++i)
+                q.push(i);
+            for (long i = 0; i < seg; ++i) {
+                const bool ok = q.try_pop(v);
+                assert(ok && v == i);
+            }
+        }
+        assert(live_allocs.load() <= base + 2);
+    }
+
+    // 多生产者、多消费者: 每个元素恰好被取出一次
+    for (int producers = 1; producers <= 4; producers += 3) {
+        for (int consumers = 1; consumers <= 4; consumers += 3) {
+            concurrent_queue<long> q;
+            const long n = 40000;
+            std::atomic<long> sum(0), count(0);
+            std::vector<std::thread> threads;
+            for (int p = 0; p < producers; ++p) {
+                threads.emplace_back([&q, n] {
+                    for (long i = 0; i < n;) {
+                        if (i % 5 == 0 && i + 4 < n) {
+                            long b[4] = {i, i + 1, i + 2, i + 3};
+                            q.push_n(b, 4);
+                            i += 4;
+                        }
+                        else {
+                            q.push(i++);
+                        }
+                    }
+                });
+            }
+            for (int c = 0; c < consumers; ++c) {
+                threads.emplace_back([&] {
+                    long out[8];
+                    while (count.load() < n * producers) {
+                        const size_t m = q.try_pop_n(out, 8);
+                        for (size_t k = 0; k < m; ++k)
+                            sum += out[k];
+                        count += static_cast<long>(m);
+                        long v;
+                        if (q.try_pop(v)) {
+                            sum += v;
+                            ++count;
+                        }
+                    }
+                });
+            }
+            for (auto &t : threads)
+                t.join();
+            assert(count.load() == n * producers);
+            assert(sum.load() == producers * (n * (n - 1) / 2));
+        }
+    }
+
+    std::cout << "concurrent_queue ok" << std::endl;
+    return 0;
+}
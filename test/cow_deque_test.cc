@@ -0,0 +1,106 @@
+#include "cow_deque.h"
+#include <cassert>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace mystl;
+
+static bool same(const cow_deque<std::string> &a, const std::deque<std::string> &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < b.size(); ++i) {
+        if (a[i] != b[i])
+            return false;
+    }
+    return true;
+}
+
+int main()
+{
+    // 随机修改原队列与若干副本, 各自与独立的 std::deque 对照
+    {
+        std::vector<cow_deque<std::string>> snaps;
+        std::vector<std::deque<std::string>> refs;
+        cow_deque<std::string> d;
+        std::deque<std::string> r;
+        for (int it = 0; it < 30000; ++it) {
+            const int op = std::rand() % 12;
+            const std::string v = std::to_string(std::rand()) + "-long-enough-for-heap";
+            if (op < 3) {
+                d.push_back(v);
+                r.push_back(v);
+            }
+            else if (op < 5) {
+                d.push_front(v);
+                r.push_front(v);
+            }
+            else if (op < 7 && !r.empty()) {
+                d.pop_front();
+                r.pop_front();
+            }
+            else if (op < 9 && !r.empty()) {
+                d.pop_back();
+                r.pop_back();
+            }
+            else if (op < 10 && !r.empty()) {
+                const size_t k = std::rand() % r.size();
+                d[k] = v;
+                r[k] = v;
+            }
+            else if (op < 11) {
+                if (snaps.size() < 8) {
+                    snaps.push_back(d);
+                    refs.push_back(r);
+                }
+                else {
+                    const size_t k = std::rand() % 8;
+                    snaps[k] = d;
+                    refs[k] = r;
+                }
+            }
+            else if (!snaps.empty()) {
+                const size_t k = std::rand() % snaps.size();
+                if (!refs[k].empty()) {
+                    snaps[k].pop_front();
+                    refs[k].pop_front();
+                }
+                snaps[k].push_back("x");
+                refs[k].push_back("x");
+            }
+            if (it % 500 == 0) {
+                assert(same(d, r));
+                for (size_t k = 0; k < snaps.size(); ++k)
+                    assert(same(snaps[k], refs[k]));
+            }
+        }
+    }
+
+    // 副本共享全部块; 写原队列只复制被写的块, 另一线程读副本不受影响
+    {
+        cow_deque<long> big;
+        const long n = 200000;
+        for (long i = 0; i < n; ++i)
+            big.push_back(i);
+        cow_deque<long> snap(big);
+        const size_t blocks = snap.shared_blocks();
+        assert(blocks > 10);
+
+        long sum = 0;
+        std::thread reader([&snap, &sum] {
+            for (auto it = snap.cbegin(); it != snap.cend(); ++it)
+                sum += *it;
+        });
+        big[0] = -1;
+        reader.join();
+        assert(sum == n * (n - 1) / 2);
+        assert(snap[0] == 0 && big[0] == -1);
+        assert(snap.shared_blocks() == blocks - 1);
+    }
+
+    std::cout << "cow_deque ok" << std::endl;
+    return 0;
+}
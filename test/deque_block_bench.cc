@@ -0,0 +1,80 @@
+// deque 的缓冲区大小 BlockBytes 从 512 B 到 64 KiB 对各操作的影响
+// 编译: g++ -std=c++11 -O2 -Itinystl test/deque_block_bench.cc
+// 参数: 元素个数 (默认 4000000)
+
+#include "deque.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+using namespace mystl;
+
+typedef std::chrono::steady_clock clock_type;
+
+static double seconds_since(clock_type::time_point start)
+{
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+// 输出尾部插入、顺序遍历、随机访问、队列式头删尾插和头部删除时每个元素的平均时间 (纳秒)
+template <size_t BlockBytes>
+void run(long n)
+{
+    deque<long, BlockBytes> d;
+
+    auto start = clock_type::now();
+    for (long i = 0; i < n; ++i)
+        d.push_back(i);
+    const double push = seconds_since(start);
+
+    start = clock_type::now();
+    long sum = 0;
+    d.for_each_segment([&sum](const long *p, size_t m) {
+        for (size_t i = 0; i < m; ++i)
+            sum += p[i];
+    });
+    const double scan = seconds_since(start);
+
+    start = clock_type::now();
+    unsigned seed = 12345;
+    for (long i = 0; i < n; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        sum += d[(seed >> 4) % n];
+    }
+    const double access = seconds_since(start);
+
+    start = clock_type::now();
+    for (long i = 0; i < n; ++i) {
+        sum += d.front();
+        d.pop_front();
+        d.push_back(i);
+    }
+    const double churn = seconds_since(start);
+
+    start = clock_type::now();
+    while (!d.empty()) {
+        sum += d.front();
+        d.pop_front();
+    }
+    const double pop = seconds_since(start);
+    if (sum < 0)
+        std::printf("bad sum\n");
+
+    std::printf("%8zu B %8.2f %8.2f %8.2f %8.2f %8.2f\n", BlockBytes,
+                push * 1e9 / n, scan * 1e9 / n, access * 1e9 / n, churn * 1e9 / n, pop * 1e9 / n);
+}
+
+int main(int argc, char **argv)
+{
+    const long n = argc > 1 ? std::atol(argv[1]) : 4000000;
+    std::printf("%10s %8s %8s %8s %8s %8s   (ns / element)\n",
+                "block", "push", "scan", "access", "churn", "pop");
+    run<512>(n);
+    run<1024>(n);
+    run<2048>(n);
+    run<4096>(n);
+    run<8192>(n);
+    run<16384>(n);
+    run<32768>(n);
+    run<65536>(n);
+    return 0;
+}
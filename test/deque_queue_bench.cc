@@ -0,0 +1,74 @@
+// 长时间运行的 deque 队列 (头删尾插) 占用的堆内存与吞吐量
+// 编译: g++ -std=c++11 -O2 -Itinystl test/deque_queue_bench.cc
+// 参数: 队列长度 (默认 100000), 总操作次数 (默认 500000000)
+// 每经过总次数的 1/10 输出一次当前占用的堆内存, 稳定状态下应保持不变
+
+#include "deque.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+using namespace mystl;
+
+// 在每块内存前记录大小, 统计当前占用的堆内存字节数
+static size_t live_bytes = 0;
+static size_t alloc_calls = 0;
+
+void* operator new(size_t n)
+{
+    void *p = std::malloc(n + sizeof(max_align_t));
+    if (p == nullptr)
+        throw std::bad_alloc();
+    *static_cast<size_t*>(p) = n;
+    live_bytes += n;
+    ++alloc_calls;
+    return static_cast<char*>(p) + sizeof(max_align_t);
+}
+
+// 与上面的 operator new 配对, GCC 无法看出两者匹配
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *p) noexcept
+{
+    if (p == nullptr)
+        return;
+    void *base = static_cast<char*>(p) - sizeof(max_align_t);
+    live_bytes -= *static_cast<size_t*>(base);
+    std::free(base);
+}
+void operator delete(void *p, size_t) noexcept { operator delete(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+int main(int argc, char **argv)
+{
+    const long len = argc > 1 ? std::atol(argv[1]) : 100000;
+    const long ops = argc > 2 ? std::atol(argv[2]) : 500000000;
+    const long step = ops / 10 > 0 ? ops / 10 : 1;
+
+    deque<long> q;
+    for (long i = 0; i < len; ++i)
+        q.push_back(i);
+
+    std::printf("%12s %12s %12s %10s\n", "ops", "heap bytes", "allocs", "ns / op");
+    auto start = std::chrono::steady_clock::now();
+    long sum = 0;
+    for (long i = 0; i < ops; ++i) {
+        sum += q.front();
+        q.pop_front();
+        q.push_back(len + i);
+        if ((i + 1) % step == 0) {
+            const auto now = std::chrono::steady_clock::now();
+            const double ns = std::chrono::duration<double>(now - start).count() * 1e9 / step;
+            std::printf("%12ld %12zu %12zu %10.2f\n", i + 1, live_bytes, alloc_calls, ns);
+            start = now;
+        }
+    }
+    if (sum < 0)
+        std::printf("bad sum\n");
+    return 0;
+}
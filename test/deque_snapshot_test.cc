@@ -0,0 +1,66 @@
+#include "deque_snapshot.h"
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdint.h>
+#include <unistd.h>
+using namespace mystl;
+
+struct point {
+    int32_t x;
+    int32_t y;
+};
+
+int main()
+{
+    char path[] = "/tmp/mystl_snapshot_XXXXXX";
+    const int fd = ::mkstemp(path);
+    assert(fd >= 0);
+
+    // 两个快照前后写入同一文件, 依次读回
+    deque<point> a;
+    for (int i = 0; i < 10000; ++i)
+        a.push_back(point{i, -i});
+    a.pop_front();
+    deque<point> empty;
+    save(a, fd);
+    save(empty, fd);
+
+    ::lseek(fd, 0, SEEK_SET);
+    deque<point> b, c;
+    c.push_back(point{1, 1});
+    load(b, fd);
+    load(c, fd);
+    assert(b.size() == a.size() && c.empty());
+    for (size_t i = 0; i < b.size(); ++i)
+        assert(b[i].x == a[i].x && b[i].y == a[i].y);
+
+    // 元素大小不同的快照被拒绝, 目标保持不变
+    ::lseek(fd, 0, SEEK_SET);
+    deque<char> wrong(3, 'z');
+    bool threw = false;
+    try {
+        load(wrong, fd);
+    }
+    catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw && wrong.size() == 3);
+
+    // 映射第一个快照, 不复制元素
+    {
+        mapped_deque_view<point> v(path);
+        assert(v.size() == a.size());
+        assert(v.front().x == 1 && v.back().x == 9999);
+        for (size_t i = 0; i < v.size(); ++i)
+            assert(v[i].y == a[i].y);
+        mapped_deque_view<point> w(mystl::move(v));
+        assert(v.empty() && w.size() == a.size());
+    }
+
+    ::close(fd);
+    ::unlink(path);
+    std::cout << "deque_snapshot ok" << std::endl;
+    return 0;
+}
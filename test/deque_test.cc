@@ -0,0 +1,473 @@
+#include "deque.h"
+#include "util.h"
+#include <cassert>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <stdint.h>
+#include <string>
+using namespace mystl;
+
+// operator new 的调用次数, 用于检查稳定状态下不再申请内存
+static long allocs = 0;
+
+void* operator new(size_t n)
+{
+    void *p = std::malloc(n == 0 ? 1 : n);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    ++allocs;
+    return p;
+}
+
+// 与上面的 operator new 配对, GCC 无法看出两者匹配
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+static int copies_left = -1;
+
+struct counted {
+    static int live;
+    int v;
+    counted(int x) : v(x) { ++live; }
+    counted(const counted &rhs) : v(rhs.v)
+    {
+        if (copies_left == 0)
+            throw std::runtime_error("copy");
+        if (copies_left > 0)
+            --copies_left;
+        ++live;
+    }
+    ~counted() { --live; }
+};
+int counted::live = 0;
+
+// 以 std::deque 为参照, 随机执行两端插入删除、中间插入删除与批量插入
+template <size_t BlockBytes>
+static void check_block_bytes()
+{
+    deque<int, BlockBytes> d;
+    std::deque<int> ref;
+    unsigned seed = 7;
+    for (int i = 0; i < 6000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        const size_t pos = ref.empty() ? 0 : (seed >> 12) % ref.size();
+        const int b[5] = {i, i + 1, i + 2, i + 3, i + 4};
+        switch ((seed >> 8) % 8) {
+        case 0: d.push_back(i); ref.push_back(i); break;
+        case 1: d.push_front(i); ref.push_front(i); break;
+        case 2: if (!ref.empty()) { d.pop_back(); ref.pop_back(); } break;
+        case 3: if (!ref.empty()) { d.pop_front(); ref.pop_front(); } break;
+        case 4: d.insert(d.begin() + pos, i); ref.insert(ref.begin() + pos, i); break;
+        case 5: if (!ref.empty()) { d.erase(d.begin() + pos); ref.erase(ref.begin() + pos); } break;
+        case 6: d.append(b, 5); ref.insert(ref.end(), b, b + 5); break;
+        default: d.prepend(b, b + 5); ref.insert(ref.begin(), b, b + 5); break;
+        }
+    }
+    assert(d.size() == ref.size());
+    for (size_t i = 0; i < ref.size(); ++i)
+        assert(d[i] == ref[i]);
+
+    deque<int, BlockBytes> c(d);
+    assert(c == d);
+    c.erase(c.begin() + 3, c.end() - 3);
+    assert(c.size() == 6 && c[5] == ref.back());
+    d.resize(d.size() + 1000, -1);
+    assert(d.back() == -1 && d[ref.size() - 1] == ref.back());
+    d.clear();
+    assert(d.empty());
+}
+
+// segments 与 for_each_segment 依次覆盖 [begin, end) 的每个元素恰好一次, 不产生空段
+template <class Deque>
+static void check_segments(Deque &d)
+{
+    size_t i = 0;
+    for (auto seg : d.segments()) {
+        assert(seg.second != 0 && seg.second <= Deque::buffer_size);
+        for (size_t k = 0; k < seg.second; ++k, ++i)
+            assert(seg.first + k == &d[i]);
+    }
+    assert(i == d.size());
+
+    const Deque &c = d;
+    i = 0;
+    c.for_each_segment([&](const int *p, size_t n) {
+        assert(n != 0);
+        for (size_t k = 0; k < n; ++k, ++i)
+            assert(p + k == &c[i]);
+    }, true);
+    assert(i == d.size());
+}
+
+int main()
+{
+    // 逐块复制可平凡复制的元素, 源与目标的块大小可以不同
+    {
+        typedef pair<uint32_t, uint32_t> pr;
+        deque<pr> a;
+        for (uint32_t i = 0; i < 5000; ++i)
+            a.push_back(pr(i, i * 3));
+        a.pop_front();
+        deque<pr> b(a);
+        assert(b.size() == a.size());
+        for (size_t i = 0; i < b.size(); ++i)
+            assert(b[i].first == i + 1 && b[i].second == (i + 1) * 3);
+
+        deque<pr, 64> c(a.begin() + 7, a.end() - 5);
+        assert(c.size() == a.size() - 12);
+        for (size_t i = 0; i < c.size(); ++i)
+            assert(c[i] == a[i + 7]);
+        deque<pr> d(c.cbegin(), c.cend());
+        assert(d.size() == c.size() && d.front() == c.front() && d.back() == c.back());
+
+        d.prepend(a.begin(), a.begin() + 100);
+        d.append(a.begin(), a.begin() + 300);
+        assert(d.size() == c.size() + 400);
+        assert(d[0] == a[0] && d[99] == a[99] && d.back() == a[299]);
+    }
+
+    // 非平凡类型逐段复制, 复制抛出异常时不留下已构造的元素
+    {
+        deque<std::string> a;
+        for (int i = 0; i < 1000; ++i)
+            a.push_back(std::to_string(i));
+        deque<std::string> b(a);
+        assert(b == a);
+
+        deque<counted> c;
+        for (int i = 0; i < 700; ++i)
+            c.emplace_back(i);
+        copies_left = 500;
+        try {
+            deque<counted> d(c);
+            assert(false);
+        }
+        catch (const std::runtime_error&) {
+        }
+        copies_left = -1;
+        assert(counted::live == 700);
+    }
+
+    // 缓冲区很小 (2 个元素) 与很大 (16384 个元素) 时行为一致
+    {
+        static_assert(deque<int, 8>::buffer_size == 2, "");
+        static_assert(deque<int, 65536>::buffer_size == 16384, "");
+        check_block_bytes<8>();
+        check_block_bytes<65536>();
+        check_block_bytes<0>();
+    }
+
+    // 长时间头删尾插: map 在原地重新居中而不是不断扩大, 预热之后不再申请内存
+    {
+        deque<int> d;
+        for (int i = 0; i < 10000; ++i)
+            d.push_back(i);
+        for (int i = 10000; i < 200000; ++i) {
+            d.pop_front();
+            d.push_back(i);
+        }
+        const long before = allocs;
+        size_t most = 0;
+        for (int i = 200000; i < 2000000; ++i) {
+            d.pop_front();
+            d.push_back(i);
+            if (i % 1000 == 0) {
+                const size_t held = d.capacity_front() + d.size() + d.capacity_back();
+                most = held > most ? held : most;
+            }
+        }
+        assert(allocs == before);
+        assert(most <= d.size() + 2 * deque<int>::buffer_size);
+        assert(d.front() == 1990000 && d.back() == 1999999);
+    }
+
+    // 空闲缓冲区缓存: 成批清空再填满的队列不再调用分配器, 缓存个数不超过上限
+    {
+        static_assert(deque<int>::spare_capacity == DEQUE_SPARE_BLOCKS, "");
+        const int bs = static_cast<int>(deque<int>::buffer_size);
+        const int burst = 3 * bs;   // 不超过缓存上限的块数
+        deque<int> d;
+        for (int i = 0; i < burst; ++i)
+            d.push_back(i);
+        // 预热: 起点不在块首时一批元素横跨 4 块, 前几轮可能还要申请缓冲区
+        for (int r = 0; r < 3; ++r) {
+            for (int i = 0; i < burst; ++i)
+                d.pop_front();
+            for (int i = 0; i < burst; ++i)
+                d.push_back(i);
+        }
+
+        const long before = allocs;
+        for (int r = 0; r < 100; ++r) {
+            for (int i = 0; i < burst; ++i)
+                d.pop_front();
+            assert(d.empty() && d.spare_blocks() >= 2);
+            for (int i = 0; i < burst; ++i)
+                d.push_back(i);
+        }
+        d.clear();
+        assert(d.spare_blocks() >= 2);
+        for (int i = 0; i < burst; ++i)
+            d.push_back(i);
+        assert(allocs == before);
+
+        for (int i = 0; i < 4 * burst; ++i)
+            d.push_back(i);
+        d.clear();
+        assert(d.spare_blocks() == deque<int>::spare_capacity);
+    }
+
+    // move_iterator 与插入迭代器; 可以求长度的源区间只扩容一次
+    {
+        deque<std::string> src;
+        for (int i = 0; i < 100; ++i)
+            src.push_back(std::string(40, static_cast<char>('a' + i % 26)));
+        deque<std::string> dst;
+        mystl::copy(mystl::make_move_iterator(src.begin()), mystl::make_move_iterator(src.end()),
+                    mystl::back_inserter(dst));
+        assert(dst.size() == 100 && dst[27] == std::string(40, 'b'));
+        for (size_t i = 0; i < src.size(); ++i)
+            assert(src[i].empty());
+
+        const int a[5] = {1, 2, 3, 4, 5};
+        deque<int> d;
+        mystl::copy(a, a + 5, mystl::front_inserter(d));
+        mystl::copy(a, a + 5, mystl::back_inserter(d));
+        auto fi = mystl::front_inserter(d);
+        *fi = 0;
+        auto bi = mystl::back_inserter(d);
+        *bi = 6;
+        const int expect[12] = {0, 5, 4, 3, 2, 1, 1, 2, 3, 4, 5, 6};
+        assert(d.size() == 12);
+        for (size_t i = 0; i < 12; ++i)
+            assert(d[i] == expect[i]);
+
+        static int big[100000];
+        deque<int> e;
+        e.push_back(-1);
+        const size_t blocks = (100000 - e.capacity_back() + deque<int>::buffer_size - 1) /
+                              deque<int>::buffer_size;
+        const long before = allocs;
+        mystl::copy(big, big + 100000, mystl::back_inserter(e));
+        assert(allocs - before <= static_cast<long>(blocks) + 1);   // 新缓冲区 + 一次 map 重新分配
+        assert(e.size() == 100001 && e.front() == -1 && e.back() == 0);
+    }
+
+    // 批量删除与 drain_front: n 为 0、n 等于 size()、删除范围恰好在块边界结束
+    {
+        typedef deque<counted, 64> cd;
+        const size_t bs = cd::buffer_size;
+        cd d;
+        d.pop_front_n(0);
+        d.pop_back_n(0);
+        assert(d.empty());
+
+        for (int i = 0; i < 5; ++i)
+            d.emplace_front(-1 - i);
+        for (int i = 0; i < static_cast<int>(6 * bs); ++i)
+            d.emplace_back(i);
+        const size_t total = d.size();
+        d.pop_front_n(0);
+        d.pop_back_n(0);
+        assert(d.size() == total && counted::live == static_cast<int>(total));
+
+        // 删到第一块的末尾, 之后第一段是一整块
+        const size_t head = (*d.segments().begin()).second;
+        assert(head < bs);
+        const int next = d[head].v;
+        d.pop_front_n(head);
+        assert(d.front().v == next && (*d.segments().begin()).second == bs);
+        assert(counted::live == static_cast<int>(d.size()));
+
+        // 从尾部删到上一块的末尾, 之后最后一段是一整块
+        size_t tail = 0;
+        for (auto seg : d.segments())
+            tail = seg.second;
+        const int last = d[d.size() - tail - 1].v;
+        d.pop_back_n(tail);
+        for (auto seg : d.segments())
+            tail = seg.second;
+        assert(tail == bs && d.back().v == last);
+        assert(counted::live == static_cast<int>(d.size()));
+
+        d.pop_back_n(d.size());
+        assert(d.empty() && counted::live == 0);
+        d.emplace_back(1);
+        d.pop_front_n(d.size());
+        assert(d.empty() && counted::live == 0);
+
+        deque<int, 64> e;
+        int out[8 * 16];
+        int *end = e.drain_front(5, out);
+        assert(end == out);
+        for (int i = 0; i < 3; ++i)
+            e.push_front(-1 - i);
+        for (int i = 0; i < static_cast<int>(4 * bs); ++i)
+            e.push_back(i);
+        const size_t first = (*e.segments().begin()).second;
+        end = e.drain_front(0, out);
+        assert(end == out && e.size() == 4 * bs + 3);
+        end = e.drain_front(first, out);
+        assert(end == out + first);
+        assert(out[0] == -3 && out[first - 1] == e.front() - 1);
+        assert((*e.segments().begin()).second == bs);
+        const size_t rest = e.size();
+        end = e.drain_front(rest + 10, out);
+        assert(end == out + rest);
+        assert(e.empty() && out[rest - 1] == static_cast<int>(4 * bs) - 1);
+    }
+
+    // reserve_back / reserve_front 之后的 n 次插入不再申请内存, 每次插入容量减一
+    {
+        deque<int> d;
+        assert(d.capacity_back() == 0 && d.capacity_front() == 0);
+        d.reserve_back(10000);
+        assert(d.capacity_back() >= 10000);
+        long before = allocs;
+        for (int i = 0; i < 10000; ++i) {
+            const size_t cap = d.capacity_back();
+            d.push_back(i);
+            assert(d.capacity_back() == cap - 1);
+        }
+        assert(allocs == before);
+
+        d.reserve_front(5000);
+        assert(d.capacity_front() >= 5000);
+        const size_t back = d.capacity_back();
+        before = allocs;
+        for (int i = 0; i < 5000; ++i) {
+            const size_t cap = d.capacity_front();
+            d.push_front(-i);
+            assert(d.capacity_front() == cap - 1);
+        }
+        assert(allocs == before);
+        assert(d.capacity_back() == back);
+
+        // 已有足够容量时什么也不做; 两端都预留后交替插入也不申请内存
+        before = allocs;
+        d.reserve_back(d.capacity_back());
+        d.reserve_front(0);
+        assert(allocs == before);
+        d.reserve_back(3000);
+        d.reserve_front(3000);
+        assert(d.capacity_back() >= 3000 && d.capacity_front() >= 3000);
+        before = allocs;
+        for (int i = 0; i < 3000; ++i) {
+            d.push_back(i);
+            d.push_front(i);
+        }
+        assert(allocs == before);
+        assert(d.size() == 21000 && d.front() == 2999 && d.back() == 2999);
+    }
+
+    // 分段遍历: 空 deque、end 位于块首、首尾在同一块内以及跨越多块
+    {
+        typedef deque<int, 64> d16;
+        const int bs = static_cast<int>(d16::buffer_size);
+        d16 d;
+        assert(d.segments().begin() == d.segments().end());
+        check_segments(d);
+
+        for (int front = 0; front < bs + 3; front += 5) {
+            for (int n = 0; n < 4 * bs; ++n) {
+                d16 e;
+                for (int i = 0; i < front; ++i)
+                    e.push_front(i);
+                for (int i = 0; i < n; ++i)
+                    e.push_back(i);
+                check_segments(e);
+            }
+        }
+
+        // 恰好填满到块末尾, end 落在下一块的块首
+        d16 e;
+        e.push_front(0);
+        const size_t first = (*e.segments().begin()).second;
+        while (e.size() < first + 2 * bs)
+            e.push_back(1);
+        check_segments(e);
+        size_t segs = 0;
+        for (auto seg : e.segments()) {
+            (void)seg;
+            ++segs;
+        }
+        assert(segs == 3);
+
+        e.clear();
+        check_segments(e);
+        e.pop_front_n(0);
+        check_segments(e);
+    }
+
+    // 默认构造与被移走的 deque 不持有堆内存, 也不申请内存
+    {
+        struct no_default {
+            int v;
+            explicit no_default(int x) : v(x) {}
+        };
+        long before = allocs;
+        {
+            deque<int> a;
+            deque<no_default> b;
+            deque<std::string> arr[16];
+            assert(a.empty() && b.empty() && arr[15].empty());
+            assert(a.begin() == a.end() && a.capacity_back() == 0 && a.capacity_front() == 0);
+            a.clear();
+            a.shrink_to_fit();
+            deque<int> c(mystl::move(a));
+            a = deque<int>();
+            a.swap(c);
+        }
+        assert(allocs == before);
+
+        deque<int> d;
+        d.push_back(1);
+        deque<int> e(mystl::move(d));
+        before = allocs;
+        assert(d.empty() && d.begin() == d.end() && d.capacity_back() == 0);
+        deque<int> f(mystl::move(d));
+        d.clear();
+        assert(allocs == before && f.empty());
+        d.push_back(2);   // 被移走的 deque 可以继续使用
+        assert(d.size() == 1 && d.front() == 2 && e.front() == 1);
+    }
+
+    // 可平凡复制但不能赋值的元素: 只能在未初始化空间上逐个构造
+    {
+        typedef pair<const int, int> kv;
+        deque<kv> a;
+        for (int i = 0; i < 1000; ++i)
+            a.emplace_back(i, -i);
+        deque<kv> b(a);
+        assert(b.size() == 1000 && b[999].first == 999 && b[999].second == -999);
+        b.prepend(a.begin(), a.begin() + 10);
+        assert(b.size() == 1010 && b.front().first == 0 && b[10].first == 0);
+
+        struct fixed { const int a; int b; };
+        fixed f = {7, 8};
+        deque<fixed> c(300, f);
+        deque<fixed> d(c);
+        assert(d.size() == 300 && d.back().a == 7 && d.back().b == 8);
+
+        fixed raw[4] = {{1, 2}, {3, 4}, {5, 6}, {7, 8}};
+        alignas(fixed) unsigned char buf[sizeof(raw)];
+        fixed *out = reinterpret_cast<fixed*>(buf);
+        mystl::uninitialized_move(raw, raw + 4, out);
+        assert(out[3].a == 7 && out[3].b == 8);
+        mystl::uninitialized_fill_n(out, 4, f);
+        assert(out[0].a == 7 && out[3].b == 8);
+    }
+
+    std::cout << "deque ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,58 @@
+// 二叉堆与 4 叉堆 (以及 8 叉堆) 在定时器队列负载下的对比
+// 编译: g++ -std=c++11 -O2 -Itinystl test/heap_bench.cc
+// 参数: 最大的待触发定时器个数 (默认 4194304), 每种大小的触发次数 (默认 2000000)
+// 负载: 堆中保持 n 个定时器, 每次取出最早到期的一个, 再以随机的延迟重新加入
+
+#include "functional.h"
+#include "queue.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+using namespace mystl;
+
+typedef std::chrono::steady_clock clock_type;
+
+static double seconds_since(clock_type::time_point start)
+{
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+// 返回每次触发 (pop + push) 的平均时间 (纳秒)
+template <size_t Arity>
+double run(long n, long fires)
+{
+    priority_queue<long, deque<long>, greater<long>, Arity> q;
+    unsigned seed = 12345;
+    for (long i = 0; i < n; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        q.push((seed >> 8) % (4 * n));
+    }
+
+    const auto start = clock_type::now();
+    long now = 0;
+    for (long i = 0; i < fires; ++i) {
+        const long deadline = q.top();
+        q.pop();
+        if (deadline < now)
+            std::printf("bad order\n");
+        now = deadline;
+        seed = seed * 1103515245u + 12345u;
+        q.push(now + 1 + static_cast<long>((seed >> 8) % (4 * n)));
+    }
+    return seconds_since(start) * 1e9 / fires;
+}
+
+int main(int argc, char **argv)
+{
+    const long max_n = argc > 1 ? std::atol(argv[1]) : 4194304;
+    const long fires = argc > 2 ? std::atol(argv[2]) : 2000000;
+
+    std::printf("%10s %10s %10s %10s\n", "timers", "2-ary", "4-ary", "8-ary");
+    for (long n = 1024; n <= max_n; n *= 4) {
+        const double t2 = run<2>(n, fires);
+        const double t4 = run<4>(n, fires);
+        const double t8 = run<8>(n, fires);
+        std::printf("%10ld %7.1f ns %7.1f ns %7.1f ns\n", n, t2, t4, t8);
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "heap_algo.h"
+#include "queue.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <queue>
+#include <vector>
+using namespace mystl;
+
+int main()
+{
+    // 与 std::priority_queue 对照, 含 d 叉堆与批量插入
+    {
+        priority_queue<int> pq;
+        priority_queue<int, deque<int>, less<int>, 4> pq4;
+        std::priority_queue<int> sq;
+        for (int r = 0; r < 20000; ++r) {
+            if (std::rand() % 3 < 2) {
+                const int v = std::rand() % 1000;
+                pq.push(v);
+                pq4.push(v);
+                sq.push(v);
+            }
+            else if (!sq.empty()) {
+                assert(pq.top() == sq.top() && pq4.top() == sq.top());
+                pq.pop();
+                pq4.pop();
+                sq.pop();
+            }
+            if (r % 1000 == 0) {
+                std::vector<int> b;
+                for (int i = 0; i < r % 3000; ++i)
+                    b.push_back(std::rand());
+                for (int x : b)
+                    sq.push(x);
+                pq.push_range(b.data(), b.data() + b.size());
+                pq4.push_range(b.data(), b.data() + b.size());
+            }
+        }
+        assert(pq.size() == sq.size() && pq4.size() == sq.size());
+        while (!sq.empty()) {
+            assert(pq.top() == sq.top() && pq4.top() == sq.top());
+            pq.pop();
+            pq4.pop();
+            sq.pop();
+        }
+    }
+
+    // 堆排序
+    {
+        int a[100];
+        for (int i = 0; i < 100; ++i)
+            a[i] = std::rand() % 50;
+        make_heap(a, a + 100);
+        sort_heap(a, a + 100);
+        assert(std::is_sorted(a, a + 100));
+
+        for (int i = 0; i < 100; ++i)
+            a[i] = std::rand() % 50;
+        dary_make_heap<3>(a, a + 100, less<int>());
+        dary_sort_heap<3>(a, a + 100, less<int>());
+        assert(std::is_sorted(a, a + 100));
+    }
+
+    std::cout << "heap ok" << std::endl;
+    return 0;
+}
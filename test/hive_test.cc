@@ -0,0 +1,72 @@
+#include "hive.h"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+using namespace mystl;
+
+int main()
+{
+    // 随机插入与删除, 与 std::multiset 对照; 元素地址在删除其它元素后保持不变
+    {
+        hive<std::string> h;
+        std::multiset<std::string> ref;
+        std::vector<std::string*> ptrs;
+        for (int round = 0; round < 100000; ++round) {
+            if (std::rand() % 3 < 2 || ptrs.empty()) {
+                const std::string s = std::to_string(std::rand() % 1000) + "-long-enough-for-heap";
+                ptrs.push_back(&*h.insert(s));
+                ref.insert(s);
+            }
+            else {
+                const size_t k = std::rand() % ptrs.size();
+                ref.erase(ref.find(*ptrs[k]));
+                h.erase(h.get_iterator(ptrs[k]));
+                ptrs[k] = ptrs.back();
+                ptrs.pop_back();
+            }
+            if (round % 5000 == 0) {
+                assert(h.size() == ref.size());
+                assert(std::multiset<std::string>(h.begin(), h.end()) == ref);
+                size_t n = 0;
+                for (auto it = h.end(); it != h.begin(); --it)
+                    ++n;
+                assert(n == h.size());
+                for (auto p : ptrs)
+                    assert(ref.count(*p) != 0);
+            }
+        }
+
+        // 边遍历边删除, 删除返回的迭代器跳过相邻的空位
+        size_t k = 0, expect = h.size() - h.size() / 2;
+        for (auto it = h.begin(); it != h.end();)
+            it = (k++ % 2) ? h.erase(it) : ++it;
+        assert(h.size() == expect);
+
+        hive<std::string> c(h);
+        assert(c.size() == h.size());
+        h.erase(h.begin(), h.end());
+        assert(h.empty() && h.begin() == h.end());
+    }
+
+    {
+        hive<char> h;
+        for (int i = 0; i < 10000; ++i)
+            h.insert('a');
+        int k = 0;
+        for (auto it = h.begin(); it != h.end();)
+            it = (k++ % 3) ? h.erase(it) : ++it;
+        assert(h.size() == 3334);
+
+        hive<int> hi{1, 2, 3};
+        int sum = 0;
+        for (int x : hi)
+            sum += x;
+        assert(sum == 6);
+    }
+
+    std::cout << "hive ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,61 @@
+// 复制 deque<pair<uint32_t, uint32_t>> 的耗时: pair 可平凡复制时按块 memmove,
+// 与布局相同但复制构造由用户提供 (只能逐个复制) 的类型对比
+// 编译: g++ -std=c++11 -O2 -Itinystl test/pair_copy_bench.cc, 参数为元素个数
+
+#include "deque.h"
+#include "util.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdint.h>
+#include <type_traits>
+using namespace mystl;
+
+typedef pair<uint32_t, uint32_t> trivial_pair;
+
+struct user_pair {
+    uint32_t first;
+    uint32_t second;
+    user_pair(uint32_t a, uint32_t b) : first(a), second(b) {}
+    user_pair(const user_pair &rhs) : first(rhs.first), second(rhs.second) {}
+    user_pair& operator=(const user_pair &rhs)
+    {
+        first = rhs.first;
+        second = rhs.second;
+        return *this;
+    }
+};
+
+static_assert(std::is_trivially_copyable<trivial_pair>::value, "pair<uint32_t, uint32_t> must be trivially copyable");
+static_assert(!std::is_trivially_copyable<user_pair>::value, "user_pair must not be trivially copyable");
+
+typedef std::chrono::steady_clock clock_type;
+
+// 复制构造 rounds 次, 返回每次的平均毫秒数
+template <class P>
+double copy_ms(long n, int rounds)
+{
+    deque<P> src;
+    for (long i = 0; i < n; ++i)
+        src.push_back(P(static_cast<uint32_t>(i), static_cast<uint32_t>(i * 3)));
+    unsigned long check = 0;
+    const auto start = clock_type::now();
+    for (int r = 0; r < rounds; ++r) {
+        deque<P> dst(src);
+        check += dst.back().second;
+    }
+    const double ms = std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+    if (check != static_cast<unsigned long>(rounds) * static_cast<uint32_t>((n - 1) * 3))
+        std::printf("bad copy\n");
+    return ms / rounds;
+}
+
+int main(int argc, char **argv)
+{
+    // 默认规模能放进缓存, 测得的主要是复制本身而不是缺页
+    const long n = argc > 1 ? std::atol(argv[1]) : 100000;
+    const int rounds = static_cast<int>(100000000 / n > 0 ? 100000000 / n : 1);
+    std::printf("pair<uint32_t, uint32_t>  %8.3f ms\n", copy_ms<trivial_pair>(n, rounds));
+    std::printf("user_pair                 %8.3f ms\n", copy_ms<user_pair>(n, rounds));
+    return 0;
+}
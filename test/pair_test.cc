@@ -0,0 +1,70 @@
+#include "deque.h"
+#include "util.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+using namespace mystl;
+
+int main()
+{
+    typedef pair<int, std::string> pr;
+
+    // tuple_size / tuple_element / get
+    {
+        static_assert(std::tuple_size<pr>::value == 2, "");
+        static_assert(std::tuple_size<const pr>::value == 2, "");
+        static_assert(std::is_same<std::tuple_element<0, pr>::type, int>::value, "");
+        static_assert(std::is_same<std::tuple_element<1, pr>::type, std::string>::value, "");
+        static_assert(std::is_same<decltype(mystl::get<1>(std::declval<pr&>())), std::string&>::value, "");
+        static_assert(std::is_same<decltype(mystl::get<1>(std::declval<const pr&>())),
+                                   const std::string&>::value, "");
+        static_assert(std::is_same<decltype(mystl::get<1>(std::declval<pr>())), std::string&&>::value, "");
+
+        pr p(1, "one");
+        mystl::get<0>(p) = 2;
+        mystl::get<1>(p) += "!";
+        assert(p.first == 2 && p.second == "one!");
+        const pr &c = p;
+        assert(mystl::get<0>(c) == 2 && &mystl::get<1>(c) == &p.second);
+        std::string s = mystl::get<1>(mystl::move(p));
+        assert(s == "one!");
+    }
+
+#if __cplusplus >= 201703L
+    // 结构化绑定: 按值、按引用、const 引用, 以及遍历 deque<pair>
+    {
+        pr p(3, "three");
+        auto [a, b] = p;
+        a = 0;
+        b.clear();
+        assert(p.first == 3 && p.second == "three");
+
+        auto &[x, y] = p;
+        x = 4;
+        y = "four";
+        assert(p.first == 4 && p.second == "four");
+
+        const auto &[cx, cy] = p;
+        static_assert(std::is_const<std::remove_reference<decltype(cy)>::type>::value, "");
+        assert(cx == 4 && &cy == &p.second);
+
+        auto [m, n] = mystl::make_pair(5, std::string("five"));
+        assert(m == 5 && n == "five");
+
+        deque<pair<int, int>> d;
+        for (int i = 0; i < 3000; ++i)
+            d.push_back(pair<int, int>(i, 2 * i));
+        long sum = 0;
+        for (auto &[k, v] : d) {
+            v += k;
+            sum += v;
+        }
+        assert(sum == 3L * 3000 * 2999 / 2 && d[100].second == 300);
+    }
+#endif
+
+    std::cout << "pair ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,72 @@
+// 无分支 lower_bound、eytzinger_index 与 std::lower_bound 在不同表大小下的查找时间
+// 编译: g++ -std=c++11 -O2 -Itinystl test/search_bench.cc
+// 参数: 最大的表大小 (MB, 默认 256), 每种大小的查找次数 (默认 2000000)
+// 表大小从 4 KB 起每次翻倍, 依次落在 L1、L2、L3 和主存中
+
+#include "algo.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+using namespace mystl;
+
+typedef std::chrono::steady_clock clock_type;
+
+static double seconds_since(clock_type::time_point start)
+{
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+// 对每个查找值调用 f, 返回平均每次查找的时间 (纳秒); 结果累加到 sum 中防止被优化掉
+template <class F>
+double time_queries(const std::vector<int> &keys, long &sum, F f)
+{
+    const auto start = clock_type::now();
+    for (size_t i = 0; i < keys.size(); ++i)
+        sum += f(keys[i]);
+    return seconds_since(start) * 1e9 / keys.size();
+}
+
+int main(int argc, char **argv)
+{
+    const long max_mb  = argc > 1 ? std::atol(argv[1]) : 256;
+    const long queries = argc > 2 ? std::atol(argv[2]) : 2000000;
+
+    std::printf("%10s %12s %12s %12s\n", "size", "std", "branchless", "eytzinger");
+    for (size_t bytes = 4096; bytes <= (static_cast<size_t>(max_mb) << 20); bytes *= 2) {
+        const size_t n = bytes / sizeof(int);
+        std::vector<int> v(n);
+        for (size_t i = 0; i < n; ++i)
+            v[i] = static_cast<int>(2 * i);
+        eytzinger_index<int> e(v.data(), v.data() + n);
+
+        std::vector<int> keys(queries);
+        unsigned seed = 12345;
+        for (long i = 0; i < queries; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            keys[i] = static_cast<int>((seed >> 4) % (2 * n));
+        }
+
+        const int *first = v.data(), *last = v.data() + n;
+        long sum = 0;
+        const double t_std = time_queries(keys, sum, [=](int k) {
+            return std::lower_bound(first, last, k) - first;
+        });
+        const double t_bl = time_queries(keys, sum, [=](int k) {
+            return mystl::lower_bound(first, last, k) - first;
+        });
+        const double t_ey = time_queries(keys, sum, [&e](int k) {
+            const int *p = e.lower_bound(k);
+            return p == nullptr ? 0L : static_cast<long>(*p);
+        });
+        if (sum < 0)
+            std::printf("bad sum\n");
+
+        if (bytes < (1 << 20))
+            std::printf("%7zu KB %9.1f ns %9.1f ns %9.1f ns\n", bytes >> 10, t_std, t_bl, t_ey);
+        else
+            std::printf("%7zu MB %9.1f ns %9.1f ns %9.1f ns\n", bytes >> 20, t_std, t_bl, t_ey);
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "algo.h"
+#include "deque.h"
+#include "set_algo.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace mystl;
+
+// tag 用于检查稳定性
+struct item {
+    int key;
+    int tag;
+    bool operator<(const item &rhs) const { return key < rhs.key; }
+    bool operator==(const item &rhs) const { return key == rhs.key && tag == rhs.tag; }
+};
+
+int main()
+{
+    for (int it = 0; it < 2000; ++it) {
+        // 每三轮有一轮让 b 远长于 a, 走 galloping 分支
+        const int n1 = std::rand() % 60;
+        const int n2 = std::rand() % (it % 3 == 0 ? 2000 : 60);
+        const int range = 1 + std::rand() % 100;
+        std::vector<item> a(n1), b(n2);
+        for (int i = 0; i < n1; ++i)
+            a[i] = item{std::rand() % range, i};
+        for (int i = 0; i < n2; ++i)
+            b[i] = item{std::rand() % range, 1000 + i};
+        std::stable_sort(a.begin(), a.end());
+        std::stable_sort(b.begin(), b.end());
+        deque<item> da(a.data(), a.data() + n1), db(b.data(), b.data() + n2);
+
+        std::vector<item> r1(n1 + n2), r2(n1 + n2);
+        std::merge(a.begin(), a.end(), b.begin(), b.end(), r1.begin());
+        mystl::merge(da.begin(), da.end(), b.data(), b.data() + n2, r2.data());
+        assert(r1 == r2);
+
+        auto e1 = std::set_union(a.begin(), a.end(), b.begin(), b.end(), r1.begin());
+        auto e2 = mystl::set_union(a.data(), a.data() + n1, db.begin(), db.end(), r2.data());
+        assert(e1 - r1.begin() == e2 - r2.data() && std::equal(r1.begin(), e1, r2.data()));
+
+        e1 = std::set_intersection(b.begin(), b.end(), a.begin(), a.end(), r1.begin());
+        e2 = mystl::set_intersection(db.begin(), db.end(), da.begin(), da.end(), r2.data());
+        assert(e1 - r1.begin() == e2 - r2.data() && std::equal(r1.begin(), e1, r2.data()));
+
+        std::vector<item> c = a;
+        c.insert(c.end(), b.begin(), b.end());
+        deque<item> dc(c.data(), c.data() + c.size());
+        std::inplace_merge(c.begin(), c.begin() + n1, c.end());
+        mystl::inplace_merge(dc.begin(), dc.begin() + n1, dc.end());
+        for (size_t i = 0; i < c.size(); ++i)
+            assert(dc[i] == c[i]);
+    }
+
+    std::string s[] = {"b", "d", "f", "a", "c", "e", "g"};
+    mystl::inplace_merge(s, s + 3, s + 7);
+    assert(std::is_sorted(s, s + 7));
+
+    std::cout << "set_algo ok" << std::endl;
+    return 0;
+}
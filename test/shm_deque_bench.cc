@@ -0,0 +1,70 @@
+// shm_deque 的两进程吞吐量: 子进程逐个或成批放入, 父进程逐个或成批取出
+// 编译: g++ -std=c++11 -O2 -Itinystl test/shm_deque_bench.cc -lrt -pthread, 参数为传递的元素个数
+
+#include "shm_deque.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+using namespace mystl;
+
+typedef std::chrono::steady_clock clock_type;
+typedef shm_deque<long> queue_type;
+
+// batch 为 1 时使用 push_back/pop_front, 否则使用 push_back_n/pop_front_n; 返回每秒传递的元素个数
+static double run(const char *name, long n, size_t batch)
+{
+    queue_type::unlink(name);
+    queue_type q = queue_type::create(name, 16 << 20);
+    const auto start = clock_type::now();
+    const pid_t pid = fork();
+    if (pid == 0) {
+        queue_type c = queue_type::open(name);
+        long buf[256];
+        for (long i = 0; i < n;) {
+            size_t m = 1;
+            if (batch == 1) {
+                if (!c.push_back(i))
+                    m = 0;
+            }
+            else {
+                m = n - i < static_cast<long>(batch) ? static_cast<size_t>(n - i) : batch;
+                for (size_t k = 0; k < m; ++k)
+                    buf[k] = i + static_cast<long>(k);
+                m = c.push_back_n(buf, m);
+            }
+            if (m == 0)
+                std::this_thread::yield();
+            i += static_cast<long>(m);
+        }
+        _exit(0);
+    }
+    long buf[256], sum = 0;
+    for (long got = 0; got < n;) {
+        size_t m = batch == 1 ? (q.pop_front(buf[0]) ? 1 : 0) : q.pop_front_n(buf, batch);
+        if (m == 0)
+            std::this_thread::yield();
+        for (size_t k = 0; k < m; ++k)
+            sum += buf[k];
+        got += static_cast<long>(m);
+    }
+    waitpid(pid, nullptr, 0);
+    const double sec = std::chrono::duration<double>(clock_type::now() - start).count();
+    queue_type::unlink(name);
+    if (sum != n * (n - 1) / 2)
+        std::printf("bad sum\n");
+    return n / sec;
+}
+
+int main(int argc, char **argv)
+{
+    const long n = argc > 1 ? std::atol(argv[1]) : 5000000;
+    char name[64];
+    std::snprintf(name, sizeof(name), "/mystl_shm_deque_bench_%d", static_cast<int>(getpid()));
+    const size_t batches[] = {1, 16, 256};
+    for (size_t b : batches)
+        std::printf("batch %3zu  %8.2f M/s\n", b, run(name, n, b) / 1e6);
+    return 0;
+}
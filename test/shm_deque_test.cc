@@ -0,0 +1,89 @@
+#include "shm_deque.h"
+#include <cassert>
+#include <iostream>
+#include <signal.h>
+#include <stdexcept>
+#include <stdio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+using namespace mystl;
+
+int main()
+{
+    char name[64];
+    snprintf(name, sizeof(name), "/mystl_shm_deque_test_%d", static_cast<int>(getpid()));
+
+    // 两个进程经同一区域传递元素
+    {
+        shm_deque<long, 256>::unlink(name);
+        auto q = shm_deque<long, 256>::create(name, 1 << 16);
+        const pid_t pid = fork();
+        if (pid == 0) {
+            auto c = shm_deque<long, 256>::open(name);
+            for (long i = 0; i < 1000; ++i)
+                while (!c.push_back(i)) {}
+            _exit(0);
+        }
+        long expect = 0, v = 0;
+        while (expect < 1000) {
+            if (q.pop_front(v)) {
+                assert(v == expect);
+                ++expect;
+            }
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+        const bool pushed = q.push_front(1) && q.push_front(0) && q.push_back(2);
+        assert(pushed);
+        long out[4];
+        const size_t got = q.pop_front_n(out, 4);
+        assert(got == 3);
+        assert(out[0] == 0 && out[1] == 1 && out[2] == 2);
+        assert(q.empty());
+        shm_deque<long, 256>::unlink(name);
+    }
+
+    // 写入者被杀死后: 要么队列仍然一致, 要么所有操作都报告区域不可恢复
+    for (int round = 0; round < 20; ++round) {
+        shm_deque<long, 256>::unlink(name);
+        auto q = shm_deque<long, 256>::create(name, 1 << 20);
+        const pid_t pid = fork();
+        if (pid == 0) {
+            auto c = shm_deque<long, 256>::open(name);
+            for (long i = 0;; ++i) {
+                // 区域已满时从队头丢弃元素, 直到放入成功; 一次 pop 不一定空出一整块
+                long v;
+                while (!c.push_back(i))
+                    c.pop_front(v);
+            }
+        }
+        usleep(1000 + round * 500);
+        kill(pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+        try {
+            long prev = -1, v = 0;
+            while (q.pop_front(v)) {
+                assert(prev < 0 || v == prev + 1);
+                prev = v;
+            }
+            const bool ok = q.push_back(7) && q.pop_back(v);
+            assert(ok && v == 7);
+        }
+        catch (const std::runtime_error&) {
+            bool threw = false;
+            try {
+                q.clear();
+            }
+            catch (const std::runtime_error&) {
+                threw = true;
+            }
+            assert(threw);
+        }
+        shm_deque<long, 256>::unlink(name);
+    }
+
+    std::cout << "shm_deque ok" << std::endl;
+    return 0;
+}
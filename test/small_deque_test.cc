@@ -0,0 +1,92 @@
+#include "small_deque.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <type_traits>
+using namespace mystl;
+
+struct throwing_move {
+    int v;
+    throwing_move(int x) : v(x) {}
+    throwing_move(const throwing_move &rhs) : v(rhs.v) {}
+    throwing_move(throwing_move &&rhs) noexcept(false) : v(rhs.v) {}
+};
+
+// moves_left 用完后移动构造抛出异常, 移动成功时源对象置为 -1
+static int moves_left = 1 << 30;
+struct fragile_move {
+    int v;
+    fragile_move(int x) : v(x) {}
+    fragile_move(const fragile_move &rhs) : v(rhs.v) {}
+    fragile_move(fragile_move &&rhs) : v(rhs.v)
+    {
+        if (--moves_left < 0)
+            throw 1;
+        rhs.v = -1;
+    }
+};
+
+int main()
+{
+    // 缓冲区已满时 push_back/push_front 的参数引用容器自身的元素
+    {
+        small_deque<std::string, 4> s;
+        for (int i = 0; i < 4; ++i)
+            s.push_back(std::string(32, static_cast<char>('a' + i)));
+        s.push_back(s.front());
+        assert(!s.is_inline());
+        assert(s.size() == 5);
+        assert(s.back() == std::string(32, 'a'));
+
+        small_deque<std::string, 4> t;
+        for (int i = 0; i < 4; ++i)
+            t.push_front(std::string(32, static_cast<char>('a' + i)));
+        t.push_front(t.back());
+        assert(t.size() == 5);
+        assert(t.front() == std::string(32, 'a'));
+        t.emplace_back(t[1]);
+        assert(t.back() == std::string(32, 'd'));
+    }
+
+    // 在内部存储与 deque 之间切换
+    {
+        small_deque<int, 4> s;
+        for (int i = 0; i < 3; ++i)
+            s.push_front(i);
+        s.push_back(10);
+        assert(s.is_inline());
+        s.push_back(11);
+        assert(!s.is_inline());
+        int expect[] = {2, 1, 0, 10, 11};
+        assert(s.size() == 5);
+        for (size_t i = 0; i < s.size(); ++i)
+            assert(s[i] == expect[i]);
+
+        small_deque<int, 4> c(s);
+        assert(c == s);
+        small_deque<int, 4> m(mystl::move(s));
+        assert(m == c && s.empty() && s.is_inline());
+        m.swap(s);
+        assert(s == c && m.empty());
+    }
+
+    // 搬到 deque 时移动构造可能抛出异常的元素被复制, 不会留下被移走的元素
+    {
+        small_deque<fragile_move, 4> s;
+        for (int i = 0; i < 4; ++i)
+            s.push_back(fragile_move(i));
+        moves_left = 1;
+        const fragile_move x(4);
+        s.push_back(x);
+        assert(!s.is_inline() && s.size() == 5);
+        for (int i = 0; i < 5; ++i)
+            assert(s[i].v == i);
+    }
+
+    static_assert(std::is_nothrow_move_constructible<small_deque<int, 4>>::value, "");
+    static_assert(!std::is_nothrow_move_constructible<small_deque<throwing_move, 4>>::value, "");
+    static_assert(!std::is_nothrow_move_assignable<small_deque<throwing_move, 4>>::value, "");
+
+    std::cout << "small_deque ok" << std::endl;
+    return 0;
+}
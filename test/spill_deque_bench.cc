@@ -0,0 +1,58 @@
+// spill_deque 在积压超出内存预算时的吞吐量, 与全部常驻内存的 deque 对比
+// 编译: g++ -std=c++11 -O2 -Itinystl test/spill_deque_bench.cc
+// 参数: 积压的总字节数 (MB, 默认 256), 内存预算 (MB, 默认 32), 溢出文件所在目录 (默认 $TMPDIR 或 /tmp)
+
+#include "deque.h"
+#include "spill_deque.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+using namespace mystl;
+
+typedef std::chrono::steady_clock clock_type;
+
+static double seconds_since(clock_type::time_point start)
+{
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+// 先积压 n 个元素再全部取出, 分别输出两个阶段每秒处理的字节数
+template <class Queue>
+void run(const char *name, Queue &q, long n)
+{
+    auto start = clock_type::now();
+    for (long i = 0; i < n; ++i)
+        q.push_back(i);
+    const double fill = seconds_since(start);
+
+    start = clock_type::now();
+    long sum = 0;
+    for (long i = 0; i < n; ++i) {
+        sum += q.front();
+        q.pop_front();
+    }
+    const double drain = seconds_since(start);
+    if (sum != n * (n - 1) / 2)
+        std::printf("bad sum\n");
+
+    const double mb = static_cast<double>(n) * sizeof(long) / (1 << 20);
+    std::printf("%-12s fill %8.1f MB/s   drain %8.1f MB/s\n", name, mb / fill, mb / drain);
+}
+
+int main(int argc, char **argv)
+{
+    const long total_mb  = argc > 1 ? std::atol(argv[1]) : 256;
+    const long budget_mb = argc > 2 ? std::atol(argv[2]) : 32;
+    const char *dir      = argc > 3 ? argv[3] : nullptr;
+    const long n = total_mb * (1 << 20) / static_cast<long>(sizeof(long));
+
+    {
+        spill_deque<long> q(static_cast<size_t>(budget_mb) << 20, dir);
+        run("spill_deque", q, n);
+    }
+    {
+        deque<long> q;
+        run("deque", q, n);
+    }
+    return 0;
+}
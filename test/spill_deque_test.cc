@@ -0,0 +1,142 @@
+#include "spill_deque.h"
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+using namespace mystl;
+
+struct record {
+    long a;
+    int  b;
+};
+
+// 在 /proc/self/fd 中找到溢出文件的描述符
+static int spill_fd()
+{
+    for (int fd = 3; fd < 1024; ++fd) {
+        char link[64], target[256];
+        snprintf(link, sizeof(link), "/proc/self/fd/%d", fd);
+        const ssize_t n = readlink(link, target, sizeof(target) - 1);
+        if (n <= 0)
+            continue;
+        target[n] = '\0';
+        if (strstr(target, "mystl_spill_") != nullptr)
+            return fd;
+    }
+    return -1;
+}
+
+int main()
+{
+    // 小块、5 块预算下随机两端操作, 与 std::deque 对照, 常驻块数不超过预算
+    {
+        spill_deque<record, 256> q(256 * 5);
+        std::deque<long> ref;
+        for (int r = 0; r < 200000; ++r) {
+            const int op = std::rand() % 10;
+            if (op < 4) {
+                const long v = std::rand();
+                q.push_back(record{v, static_cast<int>(v)});
+                ref.push_back(v);
+            }
+            else if (op < 6) {
+                const long v = std::rand();
+                q.push_front(record{v, static_cast<int>(v)});
+                ref.push_front(v);
+            }
+            else if (op < 8 && !ref.empty()) {
+                assert(q.front().a == ref.front());
+                q.pop_front();
+                ref.pop_front();
+            }
+            else if (!ref.empty()) {
+                assert(q.back().a == ref.back() && q.back().b == static_cast<int>(ref.back()));
+                q.pop_back();
+                ref.pop_back();
+            }
+            assert(q.size() == ref.size());
+            assert(q.resident_blocks() <= 5);
+        }
+    }
+
+    // 积压超出预算的先进先出队列, 读回后顺序不变
+    {
+        spill_deque<long> q(1 << 20);
+        const long n = 1000000;
+        for (long i = 0; i < n; ++i)
+            q.push_back(i);
+        assert(q.spilled_blocks() > 0);
+        assert(q.resident_blocks() * q.buffer_size * sizeof(long) <= q.memory_budget());
+        spill_deque<long> m(mystl::move(q));
+        for (long i = 0; i < n; ++i) {
+            assert(m.front() == i);
+            m.pop_front();
+        }
+        assert(m.empty() && q.empty());
+    }
+
+    // 读回溢出块失败时 pop_front / pop_back 抛出异常, 队列保持不变, 恢复后可以继续
+    {
+        spill_deque<long, 4096> q(4096 * 3);
+        const long n = 10 * static_cast<long>(q.buffer_size);
+        for (long i = 0; i < n; ++i)
+            q.push_back(i);
+        const int fd = spill_fd();
+        assert(q.spilled_blocks() > 0 && fd >= 0);
+        const int saved = dup(fd);
+        const int null = open("/dev/null", O_RDONLY);
+
+        // 文件被换成 /dev/null 后读回只能读到 0 字节
+        dup2(null, fd);
+        long lo = 0, hi = n - 1;
+        bool threw = false;
+        while (!threw) {
+            try {
+                q.pop_front();
+                ++lo;
+            }
+            catch (const std::runtime_error&) {
+                threw = true;
+            }
+        }
+        assert(q.front() == lo && q.back() == hi);
+        assert(q.size() == static_cast<size_t>(hi - lo + 1));
+
+        threw = false;
+        while (!threw) {
+            try {
+                q.pop_back();
+                --hi;
+            }
+            catch (const std::runtime_error&) {
+                threw = true;
+            }
+        }
+        assert(q.front() == lo && q.back() == hi);
+        assert(q.size() == static_cast<size_t>(hi - lo + 1));
+
+        dup2(saved, fd);
+        close(saved);
+        close(null);
+        while (!q.empty()) {
+            assert(q.front() == lo && q.back() == hi);
+            if (lo % 2 == 0) {
+                q.pop_front();
+                ++lo;
+            }
+            else {
+                q.pop_back();
+                --hi;
+            }
+        }
+        assert(lo == hi + 1);
+    }
+
+    std::cout << "spill_deque ok" << std::endl;
+    return 0;
+}
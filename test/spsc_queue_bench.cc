@@ -0,0 +1,110 @@
+// spsc_queue 与加锁 deque 的两线程吞吐量与往返延迟对比
+// 编译: g++ -std=c++11 -O2 -Itinystl test/spsc_queue_bench.cc -pthread, 参数为传递的元素个数
+
+#include "deque.h"
+#include "spsc_queue.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+using namespace mystl;
+
+typedef std::chrono::steady_clock clock_type;
+
+// 用互斥锁保护的 deque, 提供与 spsc_queue 相同的 try_push/try_pop
+class locked_deque {
+public:
+    bool try_push(long v)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        d_.push_back(v);
+        return true;
+    }
+    bool try_pop(long &out)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (d_.empty())
+            return false;
+        out = d_.front();
+        d_.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex  mutex_;
+    deque<long> d_;
+};
+
+// 队列满或空时让出处理器, 单核机器上也能运行
+static void wait()
+{
+    std::this_thread::yield();
+}
+
+static double seconds_since(clock_type::time_point start)
+{
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+// 生产者发送 n 个数, 消费者逐个取出, 返回每秒传递的元素个数
+template <class Queue>
+double throughput(Queue &q, long n)
+{
+    const auto start = clock_type::now();
+    std::thread producer([&q, n] {
+        for (long i = 0; i < n; ++i)
+            while (!q.try_push(i)) wait();
+    });
+    long v = 0, sum = 0;
+    for (long i = 0; i < n; ++i) {
+        while (!q.try_pop(v)) wait();
+        sum += v;
+    }
+    producer.join();
+    const double sec = seconds_since(start);
+    if (sum != n * (n - 1) / 2)
+        std::printf("bad sum\n");
+    return n / sec;
+}
+
+// 两个队列之间来回传递 n 次, 返回平均往返时间 (纳秒)
+template <class Queue>
+double round_trip(Queue &ping, Queue &pong, long n)
+{
+    std::thread echo([&ping, &pong, n] {
+        long v = 0;
+        for (long i = 0; i < n; ++i) {
+            while (!ping.try_pop(v)) wait();
+            while (!pong.try_push(v)) wait();
+        }
+    });
+    const auto start = clock_type::now();
+    long v = 0;
+    for (long i = 0; i < n; ++i) {
+        while (!ping.try_push(i)) wait();
+        while (!pong.try_pop(v)) wait();
+    }
+    const double sec = seconds_since(start);
+    echo.join();
+    return sec * 1e9 / n;
+}
+
+int main(int argc, char **argv)
+{
+    const long n = argc > 1 ? std::atol(argv[1]) : 10000000;
+    const long trips = n / 50;
+    {
+        spsc_queue<long> q(4096);
+        std::printf("spsc_queue    throughput %8.1f M/s\n", throughput(q, n) / 1e6);
+        spsc_queue<long> ping(64), pong(64);
+        std::printf("spsc_queue    round trip %8.1f ns\n", round_trip(ping, pong, trips));
+    }
+    {
+        locked_deque q;
+        std::printf("locked deque  throughput %8.1f M/s\n", throughput(q, n) / 1e6);
+        locked_deque ping, pong;
+        std::printf("locked deque  round trip %8.1f ns\n", round_trip(ping, pong, trips));
+    }
+    return 0;
+}
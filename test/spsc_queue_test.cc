@@ -0,0 +1,65 @@
+#include "spsc_queue.h"
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+using namespace mystl;
+
+int main()
+{
+    // 容量取整与满/空边界
+    {
+        spsc_queue<std::string> q(3);
+        assert(q.capacity() == 4);
+        for (int i = 0; i < 4; ++i)
+            assert(q.try_push(std::to_string(i)));
+        assert(!q.try_push(std::string("x")) && q.size() == 4);
+        std::string s;
+        assert(q.try_pop(s) && s == "0");
+        std::string out[8];
+        assert(q.try_pop_n(out, 8) == 3 && out[2] == "3");
+        assert(!q.try_pop(s) && q.empty());
+    }
+
+    // 一个生产者、一个消费者, 单个与批量操作混用, 顺序不变
+    {
+        spsc_queue<std::string> q(1000);
+        const long n = 200000;
+        std::thread producer([&q, n] {
+            std::string buf[8];
+            for (long i = 0; i < n;) {
+                if (i % 3 == 0) {
+                    long k = 0;
+                    for (; k < 8 && i + k < n; ++k)
+                        buf[k] = std::to_string(i + k);
+                    i += static_cast<long>(q.try_push_n(buf, static_cast<size_t>(k)));
+                }
+                else if (q.try_push(std::to_string(i))) {
+                    ++i;
+                }
+            }
+        });
+        long expect = 0;
+        std::string out[16];
+        while (expect < n) {
+            const size_t m = q.try_pop_n(out, 16);
+            for (size_t k = 0; k < m; ++k)
+                assert(out[k] == std::to_string(expect++));
+            std::string s;
+            if (expect < n && q.try_pop(s))
+                assert(s == std::to_string(expect++));
+        }
+        producer.join();
+        assert(q.empty());
+    }
+
+    // 析构时销毁队列中剩余的元素
+    {
+        spsc_queue<std::string> q(8);
+        q.try_push(std::string(64, 'a'));
+        q.try_push(std::string(64, 'b'));
+    }
+
+    std::cout << "spsc_queue ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "thread_pool.h"
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <unistd.h>
+#include <vector>
+using namespace mystl;
+
+// 置位后大块内存的申请失败, 用于让任务队列扩容时抛出 bad_alloc
+static std::atomic<bool> fail_large_alloc(false);
+
+void* operator new(size_t n)
+{
+    if (n >= 1024 && fail_large_alloc.load())
+        throw std::bad_alloc();
+    void *p = std::malloc(n == 0 ? 1 : n);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+// 与上面的 operator new 配对, GCC 无法看出两者匹配
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+int main()
+{
+    alarm(60);   // 死锁时让测试失败而不是挂起
+
+    // parallel_for 覆盖每个下标恰好一次, 可以嵌套
+    {
+        thread_pool pool(4);
+        std::vector<std::atomic<int>> hits(10000);
+        pool.parallel_for(0, 10000, [&](int i) { hits[i].fetch_add(1); });
+        for (auto &h : hits)
+            assert(h.load() == 1);
+
+        std::atomic<long> sum(0);
+        pool.parallel_for(0, 64, [&](int i) {
+            pool.parallel_for(0, 100, [&](int j) { sum.fetch_add(i * 100 + j); }, 10);
+        });
+        assert(sum.load() == 6400L * 6399 / 2);
+
+        bool threw = false;
+        try {
+            pool.parallel_for(0, 1000, [](int i) {
+                if (i == 500)
+                    throw std::runtime_error("body");
+            });
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    // 析构函数等待全部已提交的任务
+    std::atomic<int> done(0);
+    {
+        thread_pool pool(3);
+        for (int i = 0; i < 5000; ++i)
+            pool.submit([&done] { done.fetch_add(1); });
+    }
+    assert(done.load() == 5000);
+
+    // 提交时队列扩容失败: 异常传给调用者, 析构函数仍能返回
+    done.store(0);
+    int submitted = 0;
+    {
+        thread_pool pool(2);
+        bool threw = false;
+        fail_large_alloc.store(true);
+        try {
+            for (int i = 0; i < 100000; ++i) {
+                pool.submit([&done] { done.fetch_add(1); });
+                ++submitted;
+            }
+        }
+        catch (const std::bad_alloc&) {
+            threw = true;
+        }
+        fail_large_alloc.store(false);
+        assert(threw);
+    }
+    assert(done.load() == submitted);
+
+    std::cout << "thread_pool ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,61 @@
+// tiered_deque 与 deque 的随机位置插入、删除和随机访问对比
+// 编译: g++ -std=c++11 -O2 -Itinystl test/tiered_deque_bench.cc
+// 参数: 最终的元素个数 (默认 200000)
+
+#include "deque.h"
+#include "tiered_deque.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+using namespace mystl;
+
+typedef std::chrono::steady_clock clock_type;
+
+static double seconds_since(clock_type::time_point start)
+{
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+// 线性同余生成器, 两个容器使用相同的位置序列
+static unsigned next(unsigned &seed)
+{
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+// 在随机位置插入 n 个元素, 随机读取 n 次, 再从随机位置删除一半, 输出各阶段每个操作的平均时间
+template <class Seq>
+void run(const char *name, long n)
+{
+    Seq s;
+    unsigned seed = 12345;
+
+    auto start = clock_type::now();
+    for (long i = 0; i < n; ++i)
+        s.insert(s.begin() + next(seed) % (s.size() + 1), i);
+    const double insert = seconds_since(start);
+
+    start = clock_type::now();
+    long sum = 0;
+    for (long i = 0; i < n; ++i)
+        sum += s[next(seed) % s.size()];
+    const double access = seconds_since(start);
+    if (sum < 0)
+        std::printf("bad sum\n");
+
+    start = clock_type::now();
+    for (long i = 0; i < n / 2; ++i)
+        s.erase(s.begin() + next(seed) % s.size());
+    const double erase = seconds_since(start);
+
+    std::printf("%-14s insert %9.1f ns   access %6.1f ns   erase %9.1f ns\n", name,
+                insert * 1e9 / n, access * 1e9 / n, erase * 1e9 / (n / 2));
+}
+
+int main(int argc, char **argv)
+{
+    const long n = argc > 1 ? std::atol(argv[1]) : 200000;
+    run<tiered_deque<long>>("tiered_deque", n);
+    run<deque<long>>("deque", n);
+    return 0;
+}
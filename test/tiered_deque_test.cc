@@ -0,0 +1,85 @@
+#include "tiered_deque.h"
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+using namespace mystl;
+
+// 移动构造不是 noexcept, 重建时应改用复制; 置位 fail_copy 后复制抛出异常
+static bool fail_copy = false;
+static int  copies = 0;
+
+struct item {
+    int v;
+    item(int x) : v(x) {}
+    item(const item &rhs) : v(rhs.v)
+    {
+        ++copies;
+        if (fail_copy)
+            throw std::runtime_error("copy");
+    }
+    item(item &&rhs) noexcept(false) : v(rhs.v) { rhs.v = -1; }
+    item& operator=(const item&) = default;
+    item& operator=(item &&rhs) noexcept(false) { v = rhs.v; rhs.v = -1; return *this; }
+};
+
+int main()
+{
+    // 与 std::vector 对照中间插入与删除
+    {
+        tiered_deque<int> t;
+        std::vector<int> v;
+        unsigned seed = 12345;
+        for (int i = 0; i < 20000; ++i) {
+            seed = seed * 1103515245u + 12345u;
+            const size_t pos = v.empty() ? 0 : (seed >> 8) % (v.size() + 1);
+            if (i % 3 == 2 && !v.empty() && pos < v.size()) {
+                t.erase(t.begin() + pos);
+                v.erase(v.begin() + pos);
+            }
+            else {
+                t.insert(t.begin() + pos, i);
+                v.insert(v.begin() + pos, i);
+            }
+        }
+        assert(t.size() == v.size());
+        for (size_t i = 0; i < v.size(); ++i)
+            assert(t[i] == v[i]);
+        while (!t.empty())
+            t.pop_front();
+        assert(t.block_size() == (size_t(1) << TIERED_DEQUE_MIN_SHIFT));
+    }
+
+    // 重建失败时内容不变, 已完成的插入保留; 元素个数变化一倍之前不再重试
+    {
+        tiered_deque<item> t;
+        const size_t bs = t.block_size();
+        const int n = static_cast<int>(4 * bs * bs + 3);   // 再插入一个就触发重建
+        for (int i = 0; i < n; ++i)
+            t.push_back(item(i));
+        assert(t.block_size() == bs);
+
+        fail_copy = true;
+        copies = 0;
+        t.push_back(item(n));
+        assert(copies == 1);
+        for (int i = n + 1; i < n + 100; ++i)
+            t.push_back(item(i));
+        assert(copies == 1);
+        fail_copy = false;
+        assert(t.block_size() == bs);
+        assert(t.size() == static_cast<size_t>(n) + 100);
+        for (int i = 0; i < n + 100; ++i)
+            assert(t[i].v == i);
+
+        const int m = 2 * (n + 1);
+        for (int i = n + 100; i < m; ++i)
+            t.push_back(item(i));
+        assert(t.block_size() == bs * 2);
+        for (int i = 0; i < m; ++i)
+            assert(t[i].v == i);
+    }
+
+    std::cout << "tiered_deque ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "work_stealing_deque.h"
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+using namespace mystl;
+
+int main()
+{
+    // 拥有者一端后进先出, 窃取端先进先出, 超出初始容量时扩容
+    {
+        work_stealing_deque<int> d(2);
+        for (int i = 0; i < 100; ++i)
+            d.push(i);
+        assert(d.size() == 100);
+        int x = 0;
+        assert(d.pop(x) && x == 99);
+        assert(d.steal(x) && x == 0);
+        assert(d.steal(x) && x == 1);
+        while (d.pop(x)) {}
+        assert(d.empty() && !d.steal(x));
+    }
+
+    // 拥有者 push/pop 的同时三个线程窃取: 每个元素恰好被取走一次
+    {
+        work_stealing_deque<long> d(2);
+        const long n = 200000;
+        std::atomic<long> sum(0);
+        std::atomic<bool> done(false);
+        std::vector<std::thread> thieves;
+        for (int k = 0; k < 3; ++k) {
+            thieves.emplace_back([&] {
+                long x;
+                while (!done.load() || !d.empty()) {
+                    if (d.steal(x))
+                        sum += x;
+                }
+            });
+        }
+        long x;
+        for (long i = 1; i <= n; ++i) {
+            d.push(i);
+            if (i % 3 == 0 && d.pop(x))
+                sum += x;
+        }
+        while (d.pop(x))
+            sum += x;
+        done.store(true);
+        for (auto &t : thieves)
+            t.join();
+        assert(sum.load() == n * (n + 1) / 2);
+    }
+
+    std::cout << "work_stealing_deque ok" << std::endl;
+    return 0;
+}
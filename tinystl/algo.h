@@ -0,0 +1,753 @@
+#pragma once
+
+/*
+ * 常用算法: lower_bound / upper_bound / binary_search / reverse / rotate / merge / inplace_merge
+ * 以及 eytzinger_index (按 BFS 顺序重排的有序表)
+ */
+
+#include <new>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "construct.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "uninitialized.h"
+#include "util.h"
+
+namespace mystl {
+    /*****************************************************************************************/
+    // lower_bound
+    // 在 [first, last) 中查找第一个不小于 value 的元素, 返回指向它的迭代器, 若没有则返回 last
+    /*****************************************************************************************/
+    // forward_iterator_tag 版本
+    template <class ForwardIter, class T, class Compare>
+    ForwardIter __lower_bound(ForwardIter first, ForwardIter last, const T &value,
+                              Compare comp, mystl::forward_iterator_tag)
+    {
+        auto len = mystl::distance(first, last);
+        while (len > 0) {
+            auto half = len >> 1;
+            auto middle = first;
+            mystl::advance(middle, half);
+            if (comp(*middle, value)) {
+                first = middle;
+                ++first;
+                len = len - half - 1;
+            }
+            else {
+                len = half;
+            }
+        }
+        return first;
+    }
+
+    // random_access_iterator_tag 版本
+    // 无分支二分: 循环次数只取决于区间长度, 比较结果只用于选择下标 (cmov),
+    // 同时预取下一轮可能访问的两个位置, 对 deque 迭代器同样适用
+    template <class RandomIter, class T, class Compare>
+    RandomIter __lower_bound(RandomIter first, RandomIter last, const T &value,
+                             Compare comp, mystl::random_access_iterator_tag)
+    {
+        auto len = last - first;
+        if (len <= 0)
+            return first;
+        decltype(len) base = 0;
+        while (len > 1) {
+            const auto half = len >> 1;
+            MYSTL_PREFETCH(&*(first + (base + (half >> 1))));
+            MYSTL_PREFETCH(&*(first + (base + half + (half >> 1))));
+            base = comp(first[base + half], value) ? base + half : base;
+            len -= half;
+        }
+        return first + (base + static_cast<decltype(len)>(comp(first[base], value)));
+    }
+
+    template <class ForwardIter, class T>
+    ForwardIter lower_bound(ForwardIter first, ForwardIter last, const T &value)
+    {
+        return mystl::__lower_bound(first, last, value,
+                                    [](const typename iterator_traits<ForwardIter>::value_type &a,
+                                       const T &b) { return a < b; },
+                                    iterator_category(first));
+    }
+
+    // 重载版本使用函数对象 comp 代替比较操作
+    template <class ForwardIter, class T, class Compare>
+    ForwardIter lower_bound(ForwardIter first, ForwardIter last, const T &value, Compare comp)
+    {
+        return mystl::__lower_bound(first, last, value, comp, iterator_category(first));
+    }
+
+    /*****************************************************************************************/
+    // upper_bound
+    // 在 [first, last) 中查找第一个大于 value 的元素, 返回指向它的迭代器, 若没有则返回 last
+    /*****************************************************************************************/
+    // forward_iterator_tag 版本
+    template <class ForwardIter, class T, class Compare>
+    ForwardIter __upper_bound(ForwardIter first, ForwardIter last, const T &value,
+                              Compare comp, mystl::forward_iterator_tag)
+    {
+        auto len = mystl::distance(first, last);
+        while (len > 0) {
+            auto half = len >> 1;
+            auto middle = first;
+            mystl::advance(middle, half);
+            if (comp(value, *middle)) {
+                len = half;
+            }
+            else {
+                first = middle;
+                ++first;
+                len = len - half - 1;
+            }
+        }
+        return first;
+    }
+
+    // random_access_iterator_tag 版本, 同 __lower_bound
+    template <class RandomIter, class T, class Compare>
+    RandomIter __upper_bound(RandomIter first, RandomIter last, const T &value,
+                             Compare comp, mystl::random_access_iterator_tag)
+    {
+        auto len = last - first;
+        if (len <= 0)
+            return first;
+        decltype(len) base = 0;
+        while (len > 1) {
+            const auto half = len >> 1;
+            MYSTL_PREFETCH(&*(first + (base + (half >> 1))));
+            MYSTL_PREFETCH(&*(first + (base + half + (half >> 1))));
+            base = comp(value, first[base + half]) ? base : base + half;
+            len -= half;
+        }
+        return first + (base + static_cast<decltype(len)>(!comp(value, first[base])));
+    }
+
+    template <class ForwardIter, class T>
+    ForwardIter upper_bound(ForwardIter first, ForwardIter last, const T &value)
+    {
+        return mystl::__upper_bound(first, last, value,
+                                    [](const T &a,
+                                       const typename iterator_traits<ForwardIter>::value_type &b)
+                                    { return a < b; },
+                                    iterator_category(first));
+    }
+
+    // 重载版本使用函数对象 comp 代替比较操作
+    template <class ForwardIter, class T, class Compare>
+    ForwardIter upper_bound(ForwardIter first, ForwardIter last, const T &value, Compare comp)
+    {
+        return mystl::__upper_bound(first, last, value, comp, iterator_category(first));
+    }
+
+    /*****************************************************************************************/
+    // binary_search
+    // 在 [first, last) 中查找等同于 value 的元素, 找到返回 true, 否则返回 false
+    /*****************************************************************************************/
+    template <class ForwardIter, class T>
+    bool binary_search(ForwardIter first, ForwardIter last, const T &value)
+    {
+        auto i = mystl::lower_bound(first, last, value);
+        return i != last && !(value < *i);
+    }
+
+    // 重载版本使用函数对象 comp 代替比较操作
+    template <class ForwardIter, class T, class Compare>
+    bool binary_search(ForwardIter first, ForwardIter last, const T &value, Compare comp)
+    {
+        auto i = mystl::lower_bound(first, last, value, comp);
+        return i != last && !comp(value, *i);
+    }
+
+    /*****************************************************************************************/
+    // gallop_lower_bound / gallop_upper_bound
+    // 指数搜索: 从 first 开始以 1, 3, 7, 15 ... 的步长试探, 确定范围后再二分,
+    // 目标离 first 越近代价越小 (O(log d)), 用于长度悬殊的有序序列的合并与求交
+    /*****************************************************************************************/
+    template <class RandomIter, class T, class Compare>
+    RandomIter __gallop_lower_bound(RandomIter first, RandomIter last, const T &value, Compare comp)
+    {
+        const auto len = last - first;
+        decltype(last - first) lo = 0, hi = 1;
+        while (hi < len && comp(first[hi], value)) {
+            lo = hi + 1;
+            hi = (hi << 1) + 1;
+        }
+        if (hi > len)
+            hi = len;
+        return mystl::__lower_bound(first + lo, first + hi, value, comp,
+                                    mystl::random_access_iterator_tag());
+    }
+
+    template <class RandomIter, class T, class Compare>
+    RandomIter __gallop_upper_bound(RandomIter first, RandomIter last, const T &value, Compare comp)
+    {
+        const auto len = last - first;
+        decltype(last - first) lo = 0, hi = 1;
+        while (hi < len && !comp(value, first[hi])) {
+            lo = hi + 1;
+            hi = (hi << 1) + 1;
+        }
+        if (hi > len)
+            hi = len;
+        return mystl::__upper_bound(first + lo, first + hi, value, comp,
+                                    mystl::random_access_iterator_tag());
+    }
+
+    // 连续从同一序列取出 MYSTL_MIN_GALLOP 个元素后进入 galloping 模式
+    #ifndef MYSTL_MIN_GALLOP
+    #define MYSTL_MIN_GALLOP 7
+    #endif
+
+    /*****************************************************************************************/
+    // reverse
+    // 将 [first, last) 区间内的元素反转
+    /*****************************************************************************************/
+    // bidirectional_iterator_tag 版本
+    template <class BidirectionalIter>
+    void __reverse(BidirectionalIter first, BidirectionalIter last, mystl::bidirectional_iterator_tag)
+    {
+        while (true) {
+            if (first == last || first == --last)
+                return;
+            mystl::swap(*first++, *last);
+        }
+    }
+
+    // random_access_iterator_tag 版本
+    template <class RandomIter>
+    void __reverse(RandomIter first, RandomIter last, mystl::random_access_iterator_tag)
+    {
+        while (first < last)
+            mystl::swap(*first++, *--last);
+    }
+
+    template <class BidirectionalIter>
+    void reverse(BidirectionalIter first, BidirectionalIter last)
+    {
+        mystl::__reverse(first, last, iterator_category(first));
+    }
+
+    /*****************************************************************************************/
+    // rotate
+    // 将 [first, middle) 内的元素和 [middle, last) 内的元素互换, 可以交换两个长度不同的区间
+    // 返回交换后 middle 的位置
+    /*****************************************************************************************/
+    template <class BidirectionalIter>
+    BidirectionalIter rotate(BidirectionalIter first, BidirectionalIter middle,
+                             BidirectionalIter last)
+    {
+        if (first == middle)
+            return last;
+        if (middle == last)
+            return first;
+        mystl::reverse(first, middle);
+        mystl::reverse(middle, last);
+        while (first != middle && middle != last)
+            mystl::swap(*first++, *--last);
+        if (first == middle) {
+            mystl::reverse(middle, last);
+            return last;
+        }
+        mystl::reverse(first, middle);
+        return first;
+    }
+
+    /*****************************************************************************************/
+    // merge
+    // 将两个经过排序的集合 S1 和 S2 合并起来置于另一段空间, 返回一个迭代器指向最后一个元素的下一位置
+    // 相等的元素 S1 中的排在前面 (稳定)
+    /*****************************************************************************************/
+    // 一般版本: 逐个比较
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    OutputIter __merge(InputIter1 first1, InputIter1 last1,
+                       InputIter2 first2, InputIter2 last2,
+                       OutputIter result, Compare comp,
+                       mystl::input_iterator_tag, mystl::input_iterator_tag)
+    {
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first2, *first1)) {
+                *result = *first2;
+                ++first2;
+            }
+            else {
+                *result = *first1;
+                ++first1;
+            }
+            ++result;
+        }
+        return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
+    }
+
+    // random_access_iterator_tag 版本: 某一序列连续胜出 MYSTL_MIN_GALLOP 次后,
+    // 用指数搜索找出整段可以直接输出的元素, 整段交给 copy (平凡类型走 memmove)
+    template <class RandomIter1, class RandomIter2, class OutputIter, class Compare>
+    OutputIter __merge(RandomIter1 first1, RandomIter1 last1,
+                       RandomIter2 first2, RandomIter2 last2,
+                       OutputIter result, Compare comp,
+                       mystl::random_access_iterator_tag, mystl::random_access_iterator_tag)
+    {
+        int win1 = 0, win2 = 0;
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first2, *first1)) {
+                *result = *first2;
+                ++first2;
+                ++result;
+                win1 = 0;
+                if (++win2 >= MYSTL_MIN_GALLOP && first2 != last2) {
+                    // S2 中所有小于 *first1 的元素都可以直接输出
+                    auto run_end = mystl::__gallop_lower_bound(first2, last2, *first1, comp);
+                    result = mystl::copy(first2, run_end, result);
+                    first2 = run_end;
+                    win2 = 0;
+                }
+            }
+            else {
+                *result = *first1;
+                ++first1;
+                ++result;
+                win2 = 0;
+                if (++win1 >= MYSTL_MIN_GALLOP && first1 != last1) {
+                    // S1 中所有不大于 *first2 的元素都可以直接输出
+                    auto run_end = mystl::__gallop_upper_bound(first1, last1, *first2, comp);
+                    result = mystl::copy(first1, run_end, result);
+                    first1 = run_end;
+                    win1 = 0;
+                }
+            }
+        }
+        return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
+    }
+
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    OutputIter __merge(InputIter1 first1, InputIter1 last1,
+                       InputIter2 first2, InputIter2 last2,
+                       OutputIter result, Compare comp)
+    {
+        typedef typename std::conditional<
+            mystl::is_random_access_iterator<InputIter1>::value &&
+            mystl::is_random_access_iterator<InputIter2>::value,
+            mystl::random_access_iterator_tag, mystl::input_iterator_tag>::type Category;
+        return mystl::__merge(first1, last1, first2, last2, result, comp,
+                              Category(), Category());
+    }
+
+    template <class InputIter1, class InputIter2, class OutputIter>
+    OutputIter merge(InputIter1 first1, InputIter1 last1,
+                     InputIter2 first2, InputIter2 last2, OutputIter result)
+    {
+        return mystl::__merge(first1, last1, first2, last2, result,
+                              [](const typename iterator_traits<InputIter2>::value_type &a,
+                                 const typename iterator_traits<InputIter1>::value_type &b)
+                              { return a < b; });
+    }
+
+    // 重载版本使用函数对象 comp 代替比较操作
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    OutputIter merge(InputIter1 first1, InputIter1 last1,
+                     InputIter2 first2, InputIter2 last2, OutputIter result, Compare comp)
+    {
+        return mystl::__merge(first1, last1, first2, last2, result, comp);
+    }
+
+    /*****************************************************************************************/
+    // inplace_merge
+    // 把连接在一起的两个有序序列结合成单一序列并保持有序
+    // 优先向 mystl::allocator 申请较短一段大小的缓冲区, 申请失败时退化为无缓冲区的 O(n log n) 版本
+    /*****************************************************************************************/
+    // 没有缓冲区的情况下合并
+    template <class BidirectionalIter, class Distance, class Compare>
+    void __merge_without_buffer(BidirectionalIter first, BidirectionalIter middle,
+                                BidirectionalIter last, Distance len1, Distance len2,
+                                Compare comp)
+    {
+        if (len1 == 0 || len2 == 0)
+            return;
+        if (len1 + len2 == 2) {
+            if (comp(*middle, *first))
+                mystl::swap(*middle, *first);
+            return;
+        }
+        auto first_cut = first;
+        auto second_cut = middle;
+        Distance len11 = 0;
+        Distance len22 = 0;
+        if (len1 > len2) {
+            // 序列一较长, 找到序列一的中点
+            len11 = len1 >> 1;
+            mystl::advance(first_cut, len11);
+            second_cut = mystl::lower_bound(middle, last, *first_cut, comp);
+            len22 = mystl::distance(middle, second_cut);
+        }
+        else {
+            // 序列二较长, 找到序列二的中点
+            len22 = len2 >> 1;
+            mystl::advance(second_cut, len22);
+            first_cut = mystl::upper_bound(first, middle, *second_cut, comp);
+            len11 = mystl::distance(first, first_cut);
+        }
+        auto new_middle = mystl::rotate(first_cut, middle, second_cut);
+        mystl::__merge_without_buffer(first, first_cut, new_middle, len11, len22, comp);
+        mystl::__merge_without_buffer(new_middle, second_cut, last, len1 - len11,
+                                      len2 - len22, comp);
+    }
+
+    // 从前向后合并缓冲区 [first1, last1) 与 [first2, last2), 结果放到 result 开始的位置,
+    // result 与 first2 位于同一序列且 result 不会越过 first2, 缓冲区用完即可结束
+    template <class Pointer, class BidirectionalIter, class Compare>
+    void __merge_forward(Pointer first1, Pointer last1,
+                         BidirectionalIter first2, BidirectionalIter last2,
+                         BidirectionalIter result, Compare comp,
+                         mystl::bidirectional_iterator_tag)
+    {
+        while (first1 != last1) {
+            if (first2 != last2 && comp(*first2, *first1)) {
+                *result = mystl::move(*first2);
+                ++first2;
+            }
+            else {
+                *result = mystl::move(*first1);
+                ++first1;
+            }
+            ++result;
+        }
+    }
+
+    // random_access_iterator_tag 版本, 与 merge 一样在连续胜出后进入 galloping 模式
+    template <class Pointer, class RandomIter, class Compare>
+    void __merge_forward(Pointer first1, Pointer last1,
+                         RandomIter first2, RandomIter last2,
+                         RandomIter result, Compare comp,
+                         mystl::random_access_iterator_tag)
+    {
+        int win1 = 0, win2 = 0;
+        while (first1 != last1) {
+            if (first2 == last2) {
+                mystl::move(first1, last1, result);
+                return;
+            }
+            if (comp(*first2, *first1)) {
+                *result = mystl::move(*first2);
+                ++first2;
+                ++result;
+                win1 = 0;
+                if (++win2 >= MYSTL_MIN_GALLOP && first2 != last2) {
+                    auto run_end = mystl::__gallop_lower_bound(first2, last2, *first1, comp);
+                    result = mystl::move(first2, run_end, result);
+                    first2 = run_end;
+                    win2 = 0;
+                }
+            }
+            else {
+                *result = mystl::move(*first1);
+                ++first1;
+                ++result;
+                win2 = 0;
+                if (++win1 >= MYSTL_MIN_GALLOP && first1 != last1) {
+                    auto run_end = mystl::__gallop_upper_bound(first1, last1, *first2, comp);
+                    result = mystl::move(first1, run_end, result);
+                    first1 = run_end;
+                    win1 = 0;
+                }
+            }
+        }
+    }
+
+    // 从尾部开始向前合并 [first1, last1) 与 [first2, last2), 结果放到 result 之前
+    template <class BidirectionalIter1, class Pointer, class BidirectionalIter2, class Compare>
+    void __merge_backward(BidirectionalIter1 first1, BidirectionalIter1 last1,
+                          Pointer first2, Pointer last2,
+                          BidirectionalIter2 result, Compare comp)
+    {
+        if (first2 == last2)
+            return;
+        if (first1 == last1) {
+            mystl::move_backward(first2, last2, result);
+            return;
+        }
+        --last1;
+        --last2;
+        while (true) {
+            if (comp(*last2, *last1)) {
+                *--result = mystl::move(*last1);
+                if (first1 == last1) {
+                    mystl::move_backward(first2, ++last2, result);
+                    return;
+                }
+                --last1;
+            }
+            else {
+                *--result = mystl::move(*last2);
+                if (first2 == last2)
+                    return;
+                --last2;
+            }
+        }
+    }
+
+    // 有缓冲区的情况下合并, buffer 为未初始化的空间
+    template <class BidirectionalIter, class Distance, class Pointer, class Compare>
+    void __merge_adaptive(BidirectionalIter first, BidirectionalIter middle,
+                          BidirectionalIter last, Distance len1, Distance len2,
+                          Pointer buffer, Compare comp)
+    {
+        if (len1 <= len2) {
+            // 序列一较短, 移入缓冲区后从前向后合并, 写入位置不会越过序列二的读取位置
+            auto buffer_end = mystl::uninitialized_move(first, middle, buffer);
+            try {
+                mystl::__merge_forward(buffer, buffer_end, middle, last, first, comp,
+                                       iterator_category(first));
+            }
+            catch (...) {
+                mystl::destroy(buffer, buffer_end);
+                throw;
+            }
+            mystl::destroy(buffer, buffer_end);
+        }
+        else {
+            // 序列二较短, 移入缓冲区后从后向前合并
+            auto buffer_end = mystl::uninitialized_move(middle, last, buffer);
+            try {
+                mystl::__merge_backward(first, middle, buffer, buffer_end, last, comp);
+            }
+            catch (...) {
+                mystl::destroy(buffer, buffer_end);
+                throw;
+            }
+            mystl::destroy(buffer, buffer_end);
+        }
+    }
+
+    template <class BidirectionalIter, class Compare>
+    void __inplace_merge(BidirectionalIter first, BidirectionalIter middle,
+                         BidirectionalIter last, Compare comp)
+    {
+        typedef typename iterator_traits<BidirectionalIter>::value_type value_type;
+        if (first == middle || middle == last)
+            return;
+        const auto len1 = mystl::distance(first, middle);
+        const auto len2 = mystl::distance(middle, last);
+        const auto buffer_len = static_cast<size_t>(mystl::min(len1, len2));
+
+        value_type *buffer = nullptr;
+        try {
+            buffer = mystl::allocator<value_type>::allocate(buffer_len);
+        }
+        catch (const std::bad_alloc &) {
+            buffer = nullptr;
+        }
+        if (buffer == nullptr) {
+            mystl::__merge_without_buffer(first, middle, last, len1, len2, comp);
+            return;
+        }
+        try {
+            mystl::__merge_adaptive(first, middle, last, len1, len2, buffer, comp);
+        }
+        catch (...) {
+            mystl::allocator<value_type>::deallocate(buffer, buffer_len);
+            throw;
+        }
+        mystl::allocator<value_type>::deallocate(buffer, buffer_len);
+    }
+
+    template <class BidirectionalIter>
+    void inplace_merge(BidirectionalIter first, BidirectionalIter middle, BidirectionalIter last)
+    {
+        typedef typename iterator_traits<BidirectionalIter>::value_type value_type;
+        mystl::__inplace_merge(first, middle, last,
+                               [](const value_type &a, const value_type &b) { return a < b; });
+    }
+
+    // 重载版本使用函数对象 comp 代替比较操作
+    template <class BidirectionalIter, class Compare>
+    void inplace_merge(BidirectionalIter first, BidirectionalIter middle,
+                       BidirectionalIter last, Compare comp)
+    {
+        mystl::__inplace_merge(first, middle, last, comp);
+    }
+
+    /*****************************************************************************************/
+    /*
+     * 模板类: eytzinger_index
+     * 把一个有序序列按二叉堆的 BFS 顺序 (eytzinger 布局) 重新排列,
+     * 节点 k 的左右孩子为 2k 和 2k+1, 查找路径上前几层集中在少数缓存行中,
+     * 并且可以提前预取若干层之后的节点, 大表查找时比普通二分更少缓存缺失
+     */
+    template <class T>
+    class eytzinger_index {
+    public:
+        typedef mystl::allocator<T>   data_allocator;
+
+        typedef T                     value_type;
+        typedef T*                    pointer;
+        typedef const T*              const_pointer;
+        typedef const T&              const_reference;
+        typedef size_t                size_type;
+
+    private:
+        pointer   data_;    // data_[1..size_] 为 eytzinger 布局, data_[0] 不使用
+        size_type size_;
+
+        // 一个缓存行可以容纳的元素个数, 用于计算预取的距离
+        static constexpr size_type line_elems = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+
+    public:
+        eytzinger_index() noexcept : data_(nullptr), size_(0) {}
+
+        // [first, last) 必须是有序的
+        template <class FIter, typename std::enable_if<
+            mystl::is_forward_iterator<FIter>::value, int>::type = 0>
+        eytzinger_index(FIter first, FIter last)
+            : data_(nullptr), size_(0)
+        {
+            init(first, static_cast<size_type>(mystl::distance(first, last)));
+        }
+
+        eytzinger_index(const eytzinger_index &rhs)
+            : data_(nullptr), size_(0)
+        {
+            init(rhs.data_ + 1, rhs.size_, false);
+        }
+
+        eytzinger_index(eytzinger_index &&rhs) noexcept
+            : data_(rhs.data_), size_(rhs.size_)
+        {
+            rhs.data_ = nullptr;
+            rhs.size_ = 0;
+        }
+
+        eytzinger_index& operator=(eytzinger_index rhs) noexcept
+        {
+            swap(rhs);
+            return *this;
+        }
+
+        ~eytzinger_index()
+        {
+            release();
+        }
+
+    public:
+        bool      empty() const noexcept { return size_ == 0; }
+        size_type size()  const noexcept { return size_; }
+
+        // 第 k 个元素 (eytzinger 顺序, 从 1 开始)
+        const_reference node(size_type k) const
+        {
+            MYSTL_DEBUG(k >= 1 && k <= size_);
+            return data_[k];
+        }
+
+        // 返回第一个不小于 key 的元素的地址, 若没有则返回 nullptr
+        template <class Key>
+        const_pointer lower_bound(const Key &key) const
+        {
+            size_type k = 1;
+            while (k <= size_) {
+                MYSTL_PREFETCH(data_ + k * line_elems);
+                k = (k << 1) + static_cast<size_type>(data_[k] < key);
+            }
+            // 去掉末尾向右走的路径, 剩下的就是最后一次向左走的节点
+            k >>= trailing_ones(k) + 1;
+            return k == 0 ? nullptr : data_ + k;
+        }
+
+        template <class Key>
+        bool contains(const Key &key) const
+        {
+            const_pointer p = lower_bound(key);
+            return p != nullptr && !(key < *p);
+        }
+
+        void swap(eytzinger_index &rhs) noexcept
+        {
+            mystl::swap(data_, rhs.data_);
+            mystl::swap(size_, rhs.size_);
+        }
+
+    private:
+        static size_type trailing_ones(size_type k) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return ~k == 0 ? sizeof(size_type) * 8
+                           : static_cast<size_type>(__builtin_ctzll(~static_cast<unsigned long long>(k)));
+#else
+            size_type n = 0;
+            for (; k & 1; k >>= 1)
+                ++n;
+            return n;
+#endif
+        }
+
+        // 中序遍历 eytzinger 树, 依次放入有序序列中的元素
+        template <class FIter>
+        void init(FIter first, size_type n, bool sorted = true)
+        {
+            if (n == 0)
+                return;
+            data_ = data_allocator::allocate(n + 1);
+            size_type built = 0;
+            try {
+                if (sorted) {
+                    size_type k = 1;
+                    while (built < n) {
+                        // 中序后继: 先向右一步再一直向左走到底, 越界后回退到应访问的祖先
+                        while (k <= n)
+                            k <<= 1;
+                        k >>= trailing_ones(k) + 1;
+                        mystl::construct(data_ + k, *first);
+                        ++first;
+                        ++built;
+                        k = (k << 1) + 1;
+                    }
+                }
+                else {
+                    // 已经是 eytzinger 布局, 直接复制
+                    for (; built < n; ++built, ++first)
+                        mystl::construct(data_ + built + 1, *first);
+                }
+            }
+            catch (...) {
+                // size_ 仍为 0, 按实际申请的 n + 1 个位置释放
+                if (sorted)
+                    destroy_built(n, built);
+                else
+                    mystl::destroy(data_ + 1, data_ + built + 1);
+                data_allocator::deallocate(data_, n + 1);
+                data_ = nullptr;
+                throw;
+            }
+            size_ = n;
+        }
+
+        // 构造失败时析构中序遍历中已经构造的前 built 个节点
+        void destroy_built(size_type n, size_type built) noexcept
+        {
+            size_type k = 1;
+            for (size_type i = 0; i < built; ++i) {
+                while (k <= n)
+                    k <<= 1;
+                k >>= trailing_ones(k) + 1;
+                mystl::destroy(data_ + k);
+                k = (k << 1) + 1;
+            }
+        }
+
+        void release() noexcept
+        {
+            if (data_ != nullptr) {
+                mystl::destroy(data_ + 1, data_ + size_ + 1);
+                data_allocator::deallocate(data_, size_ + 1);
+                data_ = nullptr;
+            }
+            size_ = 0;
+        }
+    };
+
+    template <class T>
+    void swap(eytzinger_index<T> &lhs, eytzinger_index<T> &rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+};
@@ -5,6 +5,18 @@
 #include "iterator.h"
 #include "util.h"
 
+// 预取提示, 不支持的编译器上为空操作
+#if defined(__GNUC__) || defined(__clang__)
+#define MYSTL_PREFETCH(addr) __builtin_prefetch(static_cast<const void*>(addr))
+#else
+#define MYSTL_PREFETCH(addr) ((void)0)
+#endif
+
+// 缓存行大小, 并发容器用它隔开不同线程频繁写入的成员, 避免伪共享
+#ifndef MYSTL_CACHE_LINE_SIZE
+#define MYSTL_CACHE_LINE_SIZE 64
+#endif
+
 namespace mystl {
     /*****************************************************************************************/
     // max
@@ -118,6 +130,35 @@ namespace mystl {
         return result != 0 ? result < 0 : len1 < len2;
     }
 
+    /*
+     * __is_memmove_range
+     * 输入、输出都是连续迭代器且元素型别相同时, 可以直接对底层内存做 memmove,
+     * Assignable 用于判断元素是否可以按位复制 (复制赋值或移动赋值)
+     */
+    template <class InputIter, class OutputIter, template <class> class Assignable,
+              bool = is_contiguous_iterator<InputIter>::value &&
+                     is_contiguous_iterator<OutputIter>::value>
+    struct __is_memmove_range : public std::false_type {};
+
+    template <class InputIter, class OutputIter, template <class> class Assignable>
+    struct __is_memmove_range<InputIter, OutputIter, Assignable, true>
+        : public std::integral_constant<bool,
+            std::is_same<typename std::remove_cv<
+                             typename iterator_traits<InputIter>::value_type>::type,
+                         typename std::remove_cv<
+                             typename iterator_traits<OutputIter>::value_type>::type>::value &&
+            !std::is_const<typename std::remove_reference<
+                               typename iterator_traits<OutputIter>::reference>::type>::value &&
+            Assignable<typename iterator_traits<OutputIter>::value_type>::value> {};
+
+    template <class InputIter, class OutputIter>
+    using __is_memcpy_copyable = __is_memmove_range<InputIter, OutputIter,
+                                                    std::is_trivially_copy_assignable>;
+
+    template <class InputIter, class OutputIter>
+    using __is_memcpy_movable = __is_memmove_range<InputIter, OutputIter,
+                                                   std::is_trivially_move_assignable>;
+
     /*
      * copy
      * 把 [first, last) 区间内的元素拷贝到 [result, result + (last - first))内
@@ -150,22 +191,21 @@ namespace mystl {
 
     template <class InputIter, class OutputIter>
     OutputIter
-    __copy(InputIter first, InputIter last, OutputIter result)
+    __copy(InputIter first, InputIter last, OutputIter result, std::false_type)
     {
         return __copy_aux(first, last, result, iterator_category(first));
     }
 
-    // trivially copy assignable 特化版本 copy
-    template <class Tp, class Up>
-    typename std::enable_if<
-        std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
-        std::is_trivially_copy_assignable<Up>::value,
-        Up*>::type
-    __copy(Tp *first, Tp *last, Up *result)
+    // trivially copy assignable 的连续区间特化版本 copy
+    template <class InputIter, class OutputIter>
+    OutputIter
+    __copy(InputIter first, InputIter last, OutputIter result, std::true_type)
     {
-        const auto n = static_cast<size_t>(last - first);
-        if (n != 0)
-            std::memmove(result, first, n * sizeof(Up));
+        const auto n = last - first;
+        if (n > 0) {
+            std::memmove(mystl::to_address(result), mystl::to_address(first),
+                         static_cast<size_t>(n) * sizeof(*mystl::to_address(result)));
+        }
 
         return result + n;
     }
@@ -173,7 +213,66 @@ namespace mystl {
     template <class InputIter, class OutputIter>
     OutputIter copy(InputIter first, InputIter last, OutputIter result)
     {
-        return __copy(first, last, result);
+        return __copy(first, last, result, __is_memcpy_copyable<InputIter, OutputIter>{});
+    }
+
+    // 目标为 back_insert_iterator 时, 可以求长度的源区间交给容器的 insert 一次性插入,
+    // 容器只需扩容一次 (如 deque 的 require_capacity), 而不是每个元素增长一次
+    template <class InputIter, class Container>
+    back_insert_iterator<Container>
+    __copy_insert(InputIter first, InputIter last, back_insert_iterator<Container> result,
+                  mystl::input_iterator_tag)
+    {
+        for (; first != last; ++first)
+            *result = *first;
+        return result;
+    }
+
+    template <class ForwardIter, class Container>
+    back_insert_iterator<Container>
+    __copy_insert(ForwardIter first, ForwardIter last, back_insert_iterator<Container> result,
+                  mystl::forward_iterator_tag)
+    {
+        Container *c = result.get_container();
+        c->insert(c->end(), first, last);
+        return result;
+    }
+
+    template <class InputIter, class Container>
+    back_insert_iterator<Container>
+    copy(InputIter first, InputIter last, back_insert_iterator<Container> result)
+    {
+        return __copy_insert(first, last, result, iterator_category(first));
+    }
+
+    // 目标为 front_insert_iterator 时, 双向的源区间反向后一次性插入到容器头部,
+    // 结果与逐个 push_front 相同 (源区间在容器中倒序排列)
+    template <class InputIter, class Container>
+    front_insert_iterator<Container>
+    __copy_insert(InputIter first, InputIter last, front_insert_iterator<Container> result,
+                  mystl::input_iterator_tag)
+    {
+        for (; first != last; ++first)
+            *result = *first;
+        return result;
+    }
+
+    template <class BidirectionalIter, class Container>
+    front_insert_iterator<Container>
+    __copy_insert(BidirectionalIter first, BidirectionalIter last,
+                  front_insert_iterator<Container> result, mystl::bidirectional_iterator_tag)
+    {
+        Container *c = result.get_container();
+        c->insert(c->begin(), mystl::reverse_iterator<BidirectionalIter>(last),
+                  mystl::reverse_iterator<BidirectionalIter>(first));
+        return result;
+    }
+
+    template <class InputIter, class Container>
+    front_insert_iterator<Container>
+    copy(InputIter first, InputIter last, front_insert_iterator<Container> result)
+    {
+        return __copy_insert(first, last, result, iterator_category(first));
     }
 
     /*****************************************************************************************/
@@ -205,25 +304,24 @@ namespace mystl {
     template <class BidirectionalIter1, class BidirectionalIter2>
     BidirectionalIter2 
     unchecked_copy_backward(BidirectionalIter1 first, BidirectionalIter1 last,
-                            BidirectionalIter2 result)
+                            BidirectionalIter2 result, std::false_type)
     {
         return unchecked_copy_backward_cat(first, last, result,
                                             iterator_category(first));
     }
 
-    // 为 trivially_copy_assignable 类型提供特化版本
-    template <class Tp, class Up>
-    typename std::enable_if<
-    std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
-    std::is_trivially_copy_assignable<Up>::value,
-    Up*>::type
-    unchecked_copy_backward(Tp* first, Tp* last, Up* result)
+    // 为 trivially_copy_assignable 的连续区间提供特化版本
+    template <class BidirectionalIter1, class BidirectionalIter2>
+    BidirectionalIter2 
+    unchecked_copy_backward(BidirectionalIter1 first, BidirectionalIter1 last,
+                            BidirectionalIter2 result, std::true_type)
     {
-        const auto n = static_cast<size_t>(last - first);
-        if (n != 0)
+        const auto n = last - first;
+        if (n > 0)
         {
             result -= n;
-            std::memmove(result, first, n * sizeof(Up));
+            std::memmove(mystl::to_address(result), mystl::to_address(first),
+                         static_cast<size_t>(n) * sizeof(*mystl::to_address(result)));
         }
         return result;
     }
@@ -233,7 +331,9 @@ namespace mystl {
     BidirectionalIter2 
     copy_backward(BidirectionalIter1 first, BidirectionalIter1 last, BidirectionalIter2 result)
     {
-        return unchecked_copy_backward(first, last, result);
+        return unchecked_copy_backward(first, last, result,
+                                       __is_memcpy_copyable<BidirectionalIter1,
+                                                            BidirectionalIter2>{});
     }
 
     /*****************************************************************************************/
@@ -273,7 +373,7 @@ namespace mystl {
      * 从 first 位置开始填充 n 个值
      */
     template <class OutputIter, class Size, class T>
-    OutputIter __fill_n(OutputIter first, Size n, const T& value)
+    OutputIter __fill_n(OutputIter first, Size n, const T& value, std::false_type)
     {
         for (; n > 0; --n, ++first)
         {
@@ -282,26 +382,35 @@ namespace mystl {
         return first;
     }
 
-    // 为 one-byte 类型提供特化版本
-    template <class Tp, class Size, class Up>
-    typename std::enable_if<
-        std::is_integral<Tp>::value && sizeof(Tp) == 1 &&
-        !std::is_same<Tp, bool>::value &&
-        std::is_integral<Up>::value && sizeof(Up) == 1,
-        Tp*>::type
-    __fill_n(Tp* first, Size n, Up value)
+    // 为连续区间上的 one-byte 类型提供特化版本
+    template <class OutputIter, class Size, class T>
+    OutputIter __fill_n(OutputIter first, Size n, const T& value, std::true_type)
     {
         if (n > 0)
         {
-            std::memset(first, (unsigned char)value, (size_t)(n));
+            std::memset(mystl::to_address(first), (unsigned char)value, (size_t)(n));
+            return first + n;
         }
-        return first + n;
+        return first;
     }
 
+    template <class OutputIter, class T, bool = is_contiguous_iterator<OutputIter>::value>
+    struct __is_memset_fillable : public std::false_type {};
+
+    template <class OutputIter, class T>
+    struct __is_memset_fillable<OutputIter, T, true>
+        : public std::integral_constant<bool,
+            std::is_integral<typename iterator_traits<OutputIter>::value_type>::value &&
+            sizeof(typename iterator_traits<OutputIter>::value_type) == 1 &&
+            !std::is_same<typename iterator_traits<OutputIter>::value_type, bool>::value &&
+            !std::is_const<typename std::remove_reference<
+                               typename iterator_traits<OutputIter>::reference>::type>::value &&
+            std::is_integral<T>::value && sizeof(T) == 1> {};
+
     template <class OutputIter, class Size, class T>
     OutputIter fill_n(OutputIter first, Size n, const T& value)
     {
-        return __fill_n(first, n, value);
+        return __fill_n(first, n, value, __is_memset_fillable<OutputIter, T>{});
     }
 
     /*
@@ -317,7 +426,7 @@ namespace mystl {
     }
 
     template <class RandomIter, class T>
-    void __fill(RandomIter first, RandomIter last, const T &value)
+    void __fill(RandomIter first, RandomIter last, const T &value, mystl::random_access_iterator_tag)
     {
         fill_n(first, last - first, value);
     }
@@ -339,6 +448,8 @@ namespace mystl {
         for (; first != last; ++first, ++result) {
             *result = mystl::move(*first);
         }
+
+        return result;
     }
 
     // random access iteractor tag
@@ -354,22 +465,19 @@ namespace mystl {
     }
 
     template <class InputIter, class OutputIter>
-    OutputIter __move(InputIter first, InputIter last, OutputIter result)
+    OutputIter __move(InputIter first, InputIter last, OutputIter result, std::false_type)
     {
         return __move_aux(first, last, result, iterator_category(first));
     }
 
-    // trivially copy assignable 特化版本
-    template <class Tp, class Up>
-    typename std::enable_if<
-      std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
-      std::is_trivially_move_assignable<Up>::value,
-      Up*>::type
-    __move(Tp *first, Tp *last, Up *result)
+    // trivially move assignable 的连续区间特化版本
+    template <class InputIter, class OutputIter>
+    OutputIter __move(InputIter first, InputIter last, OutputIter result, std::true_type)
     {
-        const size_t n = static_cast<size_t>(last - first);
-        if (n != 0) {
-            std::memmove(result, first, n * sizeof(Up));
+        const auto n = last - first;
+        if (n > 0) {
+            std::memmove(mystl::to_address(result), mystl::to_address(first),
+                         static_cast<size_t>(n) * sizeof(*mystl::to_address(result)));
         }
 
         return result + n;
@@ -378,6 +486,64 @@ namespace mystl {
     template <class InputIter, class OutputIter>
     OutputIter move(InputIter first, InputIter last, OutputIter result)
     {
-        return __move(first, last, result);
+        return __move(first, last, result, __is_memcpy_movable<InputIter, OutputIter>{});
+    }
+
+    /*
+     * move_backward
+     * 将 [first, last) 区间内的元素移动到 [result - (last - first), result) 内
+     */
+    // bidirectional_iterator_tag 版本
+    template <class BidirectionalIter1, class BidirectionalIter2>
+    BidirectionalIter2
+    __move_backward_aux(BidirectionalIter1 first, BidirectionalIter1 last,
+                        BidirectionalIter2 result, mystl::bidirectional_iterator_tag)
+    {
+        while (first != last)
+            *--result = mystl::move(*--last);
+        return result;
+    }
+
+    // random_access_iterator_tag 版本
+    template <class RandomIter1, class RandomIter2>
+    RandomIter2
+    __move_backward_aux(RandomIter1 first, RandomIter1 last,
+                        RandomIter2 result, mystl::random_access_iterator_tag)
+    {
+        for (auto n = last - first; n > 0; --n)
+            *--result = mystl::move(*--last);
+        return result;
+    }
+
+    template <class BidirectionalIter1, class BidirectionalIter2>
+    BidirectionalIter2
+    __move_backward(BidirectionalIter1 first, BidirectionalIter1 last,
+                    BidirectionalIter2 result, std::false_type)
+    {
+        return __move_backward_aux(first, last, result, iterator_category(first));
+    }
+
+    // trivially move assignable 的连续区间特化版本
+    template <class BidirectionalIter1, class BidirectionalIter2>
+    BidirectionalIter2
+    __move_backward(BidirectionalIter1 first, BidirectionalIter1 last,
+                    BidirectionalIter2 result, std::true_type)
+    {
+        const auto n = last - first;
+        if (n > 0) {
+            result -= n;
+            std::memmove(mystl::to_address(result), mystl::to_address(first),
+                         static_cast<size_t>(n) * sizeof(*mystl::to_address(result)));
+        }
+
+        return result;
+    }
+
+    template <class BidirectionalIter1, class BidirectionalIter2>
+    BidirectionalIter2
+    move_backward(BidirectionalIter1 first, BidirectionalIter1 last, BidirectionalIter2 result)
+    {
+        return __move_backward(first, last, result,
+                               __is_memcpy_movable<BidirectionalIter1, BidirectionalIter2>{});
     }
 };
\ No newline at end of file
@@ -0,0 +1,348 @@
+#pragma once
+
+/*
+ * 模板类 bounded_blocking_queue
+ * 定容的阻塞队列, 用于生产者/消费者之间的背压: 满时 push 阻塞, 空时 pop 阻塞.
+ * 等待前先短暂自旋; 只在队列由空变为非空、由满变为不满时唤醒对方,
+ * 被唤醒的线程若发现还有剩余的元素 (或空位), 再顺次唤醒下一个同类等待者.
+ * 批量接口一次加锁搬运多个元素
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+#include "allocator.h"
+#include "construct.h"
+#include "exceptdef.h"
+#include "util.h"
+
+#ifndef BLOCKING_QUEUE_SPIN_COUNT
+#define BLOCKING_QUEUE_SPIN_COUNT 100
+#endif
+
+namespace mystl {
+    template <class T>
+    class bounded_blocking_queue {
+    public:
+        typedef T          value_type;
+        typedef T&         reference;
+        typedef const T&   const_reference;
+        typedef size_t     size_type;
+
+    private:
+        typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type slot_type;
+        typedef mystl::allocator<slot_type>                                slot_allocator;
+
+        slot_type               *slots_;
+        size_type                capacity_;
+        size_type                head_;          // 队头所在的槽位
+        std::atomic<size_type>   count_;         // 只在持锁时修改, 自旋时无锁读取
+        size_type                waiting_pop_;   // 等待元素的消费者个数
+        size_type                waiting_push_;  // 等待空位的生产者个数
+        bool                     closed_;
+        mutable std::mutex       mutex_;
+        std::condition_variable  not_empty_;
+        std::condition_variable  not_full_;
+
+    public:
+        explicit bounded_blocking_queue(size_type capacity)
+            : slots_(nullptr), capacity_(capacity), head_(0), count_(0),
+              waiting_pop_(0), waiting_push_(0), closed_(false)
+        {
+            THROW_LENGTH_ERROR_IF(capacity == 0, "bounded_blocking_queue<T>'s capacity is zero");
+            slots_ = slot_allocator::allocate(capacity);
+        }
+
+        bounded_blocking_queue(const bounded_blocking_queue&) = delete;
+        bounded_blocking_queue& operator=(const bounded_blocking_queue&) = delete;
+
+        ~bounded_blocking_queue()
+        {
+            const size_type n = count_.load(std::memory_order_relaxed);
+            for (size_type i = 0; i < n; ++i)
+                mystl::destroy(slot(i));
+            slot_allocator::deallocate(slots_, capacity_);
+        }
+
+    public:
+        size_type capacity() const noexcept { return capacity_; }
+        size_type size()     const noexcept { return count_.load(std::memory_order_relaxed); }
+        bool      empty()    const noexcept { return size() == 0; }
+        bool      closed()   const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return closed_;
+        }
+
+        // 关闭后 push 一律失败, pop 取完剩余元素后失败; 唤醒所有等待者
+        void      close();
+
+        // 阻塞直到放入, 队列已关闭时返回 false
+        template <class ...Args>
+        bool      emplace(Args&& ...args);
+        bool      push(const value_type &value) { return emplace(value); }
+        bool      push(value_type &&value)      { return emplace(mystl::move(value)); }
+
+        // 不阻塞, 队列满或已关闭时返回 false
+        bool      try_push(const value_type &value);
+        bool      try_push(value_type &&value);
+
+        // 放入 [first, first + n), 有空位就分批放入, 返回放入的个数 (只有队列关闭时才少于 n)
+        template <class IIter>
+        size_type push_n(IIter first, size_type n);
+
+        // 阻塞直到取出, 队列已关闭且为空时返回 false
+        bool      pop(value_type &out);
+
+        // 不阻塞, 队列为空时返回 false
+        bool      try_pop(value_type &out);
+
+        // 阻塞直到至少有一个元素, 然后最多取出 n 个写入 result, 返回取出的个数;
+        // 队列已关闭且为空时返回 0
+        template <class OIter>
+        size_type pop_up_to(OIter result, size_type n);
+
+    private:
+        // helper functions
+        T*        slot(size_type i) const noexcept
+        {
+            i += head_;
+            return reinterpret_cast<T*>(slots_ + (i < capacity_ ? i : i - capacity_));
+        }
+
+        void      spin_while_full() const noexcept;
+        void      spin_while_empty() const noexcept;
+        void      wait_not_full(std::unique_lock<std::mutex> &lock);
+        void      wait_not_empty(std::unique_lock<std::mutex> &lock);
+
+        template <class OIter>
+        size_type take(OIter &result, size_type n);
+        void      after_push(std::unique_lock<std::mutex> &lock, size_type before);
+        void      after_pop(std::unique_lock<std::mutex> &lock, size_type before);
+    };
+
+    /*****************************************************************************************/
+
+    template <class T>
+    void bounded_blocking_queue<T>::close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    template <class T>
+    template <class ...Args>
+    bool bounded_blocking_queue<T>::emplace(Args&& ...args)
+    {
+        spin_while_full();
+        std::unique_lock<std::mutex> lock(mutex_);
+        wait_not_full(lock);
+        if (closed_)
+            return false;
+        const size_type before = count_.load(std::memory_order_relaxed);
+        mystl::construct(slot(before), mystl::forward<Args>(args)...);
+        count_.store(before + 1, std::memory_order_relaxed);
+        after_push(lock, before);
+        return true;
+    }
+
+    template <class T>
+    bool bounded_blocking_queue<T>::try_push(const value_type &value)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const size_type before = count_.load(std::memory_order_relaxed);
+        if (closed_ || before == capacity_)
+            return false;
+        mystl::construct(slot(before), value);
+        count_.store(before + 1, std::memory_order_relaxed);
+        after_push(lock, before);
+        return true;
+    }
+
+    template <class T>
+    bool bounded_blocking_queue<T>::try_push(value_type &&value)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const size_type before = count_.load(std::memory_order_relaxed);
+        if (closed_ || before == capacity_)
+            return false;
+        mystl::construct(slot(before), mystl::move(value));
+        count_.store(before + 1, std::memory_order_relaxed);
+        after_push(lock, before);
+        return true;
+    }
+
+    template <class T>
+    template <class IIter>
+    typename bounded_blocking_queue<T>::size_type
+    bounded_blocking_queue<T>::push_n(IIter first, size_type n)
+    {
+        size_type done = 0;
+        while (done < n) {
+            spin_while_full();
+            std::unique_lock<std::mutex> lock(mutex_);
+            wait_not_full(lock);
+            if (closed_)
+                break;
+            const size_type before = count_.load(std::memory_order_relaxed);
+            const size_type room = capacity_ - before;
+            const size_type m = n - done < room ? n - done : room;
+            size_type i = 0;
+            try {
+                for (; i < m; ++i, ++first)
+                    mystl::construct(slot(before + i), *first);
+            }
+            catch (...) {
+                count_.store(before + i, std::memory_order_relaxed);
+                after_push(lock, before);
+                throw;
+            }
+            count_.store(before + m, std::memory_order_relaxed);
+            done += m;
+            after_push(lock, before);
+        }
+        return done;
+    }
+
+    template <class T>
+    bool bounded_blocking_queue<T>::pop(value_type &out)
+    {
+        value_type *p = &out;
+        return pop_up_to(p, 1) == 1;
+    }
+
+    template <class T>
+    bool bounded_blocking_queue<T>::try_pop(value_type &out)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const size_type before = count_.load(std::memory_order_relaxed);
+        if (before == 0)
+            return false;
+        value_type *p = &out;
+        take(p, 1);
+        after_pop(lock, before);
+        return true;
+    }
+
+    template <class T>
+    template <class OIter>
+    typename bounded_blocking_queue<T>::size_type
+    bounded_blocking_queue<T>::pop_up_to(OIter result, size_type n)
+    {
+        if (n == 0)
+            return 0;
+        spin_while_empty();
+        std::unique_lock<std::mutex> lock(mutex_);
+        wait_not_empty(lock);
+        const size_type before = count_.load(std::memory_order_relaxed);
+        if (before == 0)
+            return 0;  // 已关闭
+        const size_type m = take(result, n < before ? n : before);
+        after_pop(lock, before);
+        return m;
+    }
+
+    /*****************************************************************************************/
+    // helper function
+
+    // 加锁前先自旋等待一会儿, 短暂的满/空不必进入睡眠
+    template <class T>
+    void bounded_blocking_queue<T>::spin_while_full() const noexcept
+    {
+        for (int i = 0; i < BLOCKING_QUEUE_SPIN_COUNT; ++i) {
+            if (count_.load(std::memory_order_relaxed) < capacity_)
+                return;
+            std::this_thread::yield();
+        }
+    }
+
+    template <class T>
+    void bounded_blocking_queue<T>::spin_while_empty() const noexcept
+    {
+        for (int i = 0; i < BLOCKING_QUEUE_SPIN_COUNT; ++i) {
+            if (count_.load(std::memory_order_relaxed) != 0)
+                return;
+            std::this_thread::yield();
+        }
+    }
+
+    template <class T>
+    void bounded_blocking_queue<T>::wait_not_full(std::unique_lock<std::mutex> &lock)
+    {
+        while (!closed_ && count_.load(std::memory_order_relaxed) == capacity_) {
+            ++waiting_push_;
+            not_full_.wait(lock);
+            --waiting_push_;
+        }
+    }
+
+    template <class T>
+    void bounded_blocking_queue<T>::wait_not_empty(std::unique_lock<std::mutex> &lock)
+    {
+        while (!closed_ && count_.load(std::memory_order_relaxed) == 0) {
+            ++waiting_pop_;
+            not_empty_.wait(lock);
+            --waiting_pop_;
+        }
+    }
+
+    // 从队头取出 n 个元素写入 result, 须持锁且 n 不超过元素个数
+    template <class T>
+    template <class OIter>
+    typename bounded_blocking_queue<T>::size_type
+    bounded_blocking_queue<T>::take(OIter &result, size_type n)
+    {
+        // 逐个出队, 写出失败的元素留在队列中
+        for (size_type i = 0; i < n; ++i, ++result) {
+            T *p = slot(0);
+            *result = mystl::move(*p);
+            mystl::destroy(p);
+            head_ = head_ + 1 == capacity_ ? 0 : head_ + 1;
+            count_.store(count_.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+        }
+        return n;
+    }
+
+    // 由空变为非空时唤醒消费者; 放入多个元素时唤醒全部
+    template <class T>
+    void bounded_blocking_queue<T>::after_push(std::unique_lock<std::mutex> &lock, size_type before)
+    {
+        const size_type now = count_.load(std::memory_order_relaxed);
+        const bool wake = before == 0 && now != 0 && waiting_pop_ != 0;
+        const bool wake_all = wake && now - before > 1;
+        // 放入后仍有空位, 接力唤醒下一个生产者
+        const bool relay = now < capacity_ && waiting_push_ != 0;
+        lock.unlock();
+        if (wake_all)
+            not_empty_.notify_all();
+        else if (wake)
+            not_empty_.notify_one();
+        if (relay)
+            not_full_.notify_one();
+    }
+
+    // 由满变为不满时唤醒生产者; 取出多个元素时唤醒全部
+    template <class T>
+    void bounded_blocking_queue<T>::after_pop(std::unique_lock<std::mutex> &lock, size_type before)
+    {
+        const size_type now = count_.load(std::memory_order_relaxed);
+        const bool wake = before == capacity_ && now != capacity_ && waiting_push_ != 0;
+        const bool wake_all = wake && before - now > 1;
+        // 取出后仍有元素, 接力唤醒下一个消费者
+        const bool relay = now != 0 && waiting_pop_ != 0;
+        lock.unlock();
+        if (wake_all)
+            not_full_.notify_all();
+        else if (wake)
+            not_full_.notify_one();
+        if (relay)
+            not_empty_.notify_one();
+    }
+};
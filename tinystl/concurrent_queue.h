@@ -0,0 +1,435 @@
+#pragma once
+
+/*
+ * 模板类 concurrent_queue
+ * 无界的多生产者多消费者无锁队列. 与 deque 一样把元素分块存放, 块 (segment) 之间以链表相连.
+ * 入队与出队各自用 fetch_add 领取一个全局序号 (ticket), 序号决定元素所在的块和槽位;
+ * 每个槽位带一个状态, 出队者先到时把槽位标记为跳过, 入队者随后换一个序号重试.
+ * 块中所有槽位都被入队、出队双方各访问过一次后, 该块从链表中摘除, 经过两代宽限期后释放
+ */
+
+#include <atomic>
+#include <type_traits>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "construct.h"
+#include "util.h"
+
+#ifndef CONCURRENT_QUEUE_SEGMENT_SIZE
+#define CONCURRENT_QUEUE_SEGMENT_SIZE 256
+#endif
+
+namespace mystl {
+    template <class T>
+    class concurrent_queue {
+    public:
+        typedef T          value_type;
+        typedef T&         reference;
+        typedef const T&   const_reference;
+        typedef size_t     size_type;
+
+        static const size_type segment_size = CONCURRENT_QUEUE_SEGMENT_SIZE;
+
+    private:
+        // 槽位状态
+        enum : unsigned char {
+            slot_empty,      // 双方都未到
+            slot_writing,    // 入队者正在构造元素
+            slot_ready,      // 元素可取
+            slot_skipped,    // 出队者先到, 入队者需重试
+            slot_abandoned,  // 入队者构造元素时抛出异常
+            slot_done        // 元素已取走
+        };
+
+        struct slot {
+            std::atomic<unsigned char> state;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+            T* value() noexcept { return reinterpret_cast<T*>(&storage); }
+        };
+
+        struct segment {
+            std::atomic<segment*>  next;
+            segment               *retire_next;  // 待回收链表
+            size_type              base;         // 第一个槽位的序号
+            std::atomic<size_type> finished;     // 双方都已访问过的槽位个数
+            slot                   slots[segment_size];
+        };
+
+        typedef mystl::allocator<segment> segment_allocator;
+
+        // 入队、出队的序号与链表头尾各占一个缓存行
+        alignas(MYSTL_CACHE_LINE_SIZE) std::atomic<size_type> enq_;
+        alignas(MYSTL_CACHE_LINE_SIZE) std::atomic<size_type> deq_;
+        alignas(MYSTL_CACHE_LINE_SIZE) std::atomic<segment*>  head_;
+        alignas(MYSTL_CACHE_LINE_SIZE) std::atomic<segment*>  tail_;
+
+        // 回收: 正在执行操作的线程按进入时的代数计数, 上一代清零后, 更早摘除的块才能释放
+        alignas(MYSTL_CACHE_LINE_SIZE) std::atomic<unsigned>  epoch_;
+        std::atomic<size_type>  active_[2];
+        std::atomic<segment*>   retired_;     // 新摘除的块
+        std::atomic<segment*>   stage_;       // 已过一代, 再过一代即可释放
+        std::atomic_flag        reclaiming_;
+
+        // 在一次操作期间登记为活跃线程
+        class guard {
+        public:
+            // 计数之后代数未变才算登记成功, 否则按新的代数重新登记
+            explicit guard(concurrent_queue *q) noexcept
+                : q_(q)
+            {
+                for (;;) {
+                    const unsigned e = q_->epoch_.load();
+                    epoch_ = e & 1;
+                    q_->active_[epoch_].fetch_add(1);
+                    if (q_->epoch_.load() == e)
+                        break;
+                    q_->active_[epoch_].fetch_sub(1);
+                }
+            }
+            ~guard() { q_->active_[epoch_].fetch_sub(1); }
+
+        private:
+            concurrent_queue *q_;
+            unsigned          epoch_;
+        };
+
+    public:
+        concurrent_queue()
+            : enq_(0), deq_(0), head_(nullptr), tail_(nullptr), epoch_(0),
+              retired_(nullptr), stage_(nullptr)
+        {
+            active_[0].store(0);
+            active_[1].store(0);
+            reclaiming_.clear();
+            segment *s = create_segment(0);
+            head_.store(s);
+            tail_.store(s);
+        }
+
+        concurrent_queue(const concurrent_queue&) = delete;
+        concurrent_queue& operator=(const concurrent_queue&) = delete;
+
+        // 析构时不应再有其它线程访问队列
+        ~concurrent_queue();
+
+    public:
+        // 近似的元素个数
+        size_type size_approx() const noexcept
+        {
+            const size_type d = deq_.load();
+            const size_type e = enq_.load();
+            return e > d ? e - d : 0;
+        }
+        bool      empty() const noexcept { return size_approx() == 0; }
+
+        template <class ...Args>
+        void      emplace(Args&& ...args);
+        void      push(const value_type &value) { emplace(value); }
+        void      push(value_type &&value)      { emplace(mystl::move(value)); }
+
+        // 一次领取 n 个连续序号, 依次放入 [first, first + n)
+        template <class IIter>
+        void      push_n(IIter first, size_type n);
+
+        // 队列为空时返回 false
+        bool      try_pop(value_type &out);
+
+        // 最多取出 n 个元素写入 result, 返回实际取出的个数
+        template <class OIter>
+        size_type try_pop_n(OIter result, size_type n);
+
+    private:
+        // helper functions
+        segment*  create_segment(size_type base);
+        void      destroy_segment(segment *s) noexcept;
+        segment*  find_segment(segment *s, size_type ticket);
+
+        template <class ...Args>
+        bool      put(size_type ticket, Args&& ...args);
+        template <class OIter>
+        bool      take(size_type ticket, OIter &result);
+        void      abandon(size_type ticket);
+
+        void      finish_slot(segment *s) noexcept;
+        void      advance_head() noexcept;
+        void      reclaim() noexcept;
+    };
+
+    /*****************************************************************************************/
+
+    template <class T>
+    concurrent_queue<T>::~concurrent_queue()
+    {
+        segment *s = head_.load();
+        size_type d = deq_.load();
+        const size_type e = enq_.load();
+        for (; d < e; ++d) {
+            s = find_segment(s, d);
+            slot &sl = s->slots[d - s->base];
+            if (sl.state.load() == slot_ready)
+                mystl::destroy(sl.value());
+        }
+        s = head_.load();
+        while (s != nullptr) {
+            segment *next = s->next.load();
+            destroy_segment(s);
+            s = next;
+        }
+        for (s = retired_.load(); s != nullptr; ) {
+            segment *next = s->retire_next;
+            destroy_segment(s);
+            s = next;
+        }
+        for (s = stage_.load(); s != nullptr; ) {
+            segment *next = s->retire_next;
+            destroy_segment(s);
+            s = next;
+        }
+    }
+
+    template <class T>
+    template <class ...Args>
+    void concurrent_queue<T>::emplace(Args&& ...args)
+    {
+        guard g(this);
+        while (!put(enq_.fetch_add(1), mystl::forward<Args>(args)...))
+            ;
+    }
+
+    template <class T>
+    template <class IIter>
+    void concurrent_queue<T>::push_n(IIter first, size_type n)
+    {
+        if (n == 0)
+            return;
+        guard g(this);
+        const size_type t = enq_.fetch_add(n);
+        size_type i = 0;  // [t, t + i) 的序号已处理完
+        try {
+            for (; i < n; ++first) {
+                // 被出队者跳过的序号作废, 改为单独领取新序号
+                const bool placed = put(t + i, *first);
+                ++i;
+                if (!placed) {
+                    while (!put(enq_.fetch_add(1), *first))
+                        ;
+                }
+            }
+        }
+        catch (...) {
+            // 剩余的序号不再使用, 让出队者跳过. t + i 可能还未领取 (*first 或 ++first 抛出),
+            // 也可能已在构造失败时标记为放弃, 由 abandon 区分
+            for (; i < n; ++i)
+                abandon(t + i);
+            throw;
+        }
+    }
+
+    template <class T>
+    bool concurrent_queue<T>::try_pop(value_type &out)
+    {
+        guard g(this);
+        advance_head();
+        value_type *p = &out;
+        while (deq_.load() < enq_.load()) {
+            if (take(deq_.fetch_add(1), p))
+                return true;
+        }
+        return false;
+    }
+
+    template <class T>
+    template <class OIter>
+    typename concurrent_queue<T>::size_type
+    concurrent_queue<T>::try_pop_n(OIter result, size_type n)
+    {
+        guard g(this);
+        advance_head();
+        size_type got = 0;
+        while (got < n) {
+            const size_type d = deq_.load();
+            const size_type e = enq_.load();
+            if (d >= e)
+                break;
+            const size_type want = mystl::min(n - got, e - d);
+            size_type t = deq_.fetch_add(want);
+            for (size_type i = 0; i < want; ++i) {
+                if (take(t + i, result))
+                    ++got;
+            }
+        }
+        return got;
+    }
+
+    /*****************************************************************************************/
+    // helper function
+
+    template <class T>
+    typename concurrent_queue<T>::segment* concurrent_queue<T>::create_segment(size_type base)
+    {
+        segment *s = segment_allocator::allocate(1);
+        s->next.store(nullptr, std::memory_order_relaxed);
+        s->retire_next = nullptr;
+        s->base = base;
+        s->finished.store(0, std::memory_order_relaxed);
+        for (size_type i = 0; i < segment_size; ++i)
+            s->slots[i].state.store(slot_empty, std::memory_order_relaxed);
+        return s;
+    }
+
+    template <class T>
+    void concurrent_queue<T>::destroy_segment(segment *s) noexcept
+    {
+        segment_allocator::deallocate(s, 1);
+    }
+
+    // 从 s 开始向后找序号 ticket 所在的块, 必要时追加新块并推进 tail_
+    template <class T>
+    typename concurrent_queue<T>::segment*
+    concurrent_queue<T>::find_segment(segment *s, size_type ticket)
+    {
+        if (s->base > ticket) {
+            // 未完成的块不会被摘除, 从头找一定能找到
+            s = head_.load();
+        }
+        while (ticket >= s->base + segment_size) {
+            segment *next = s->next.load();
+            if (next == nullptr) {
+                segment *fresh = create_segment(s->base + segment_size);
+                if (s->next.compare_exchange_strong(next, fresh)) {
+                    next = fresh;
+                }
+                else {
+                    destroy_segment(fresh);
+                }
+            }
+            segment *expected = s;
+            tail_.compare_exchange_strong(expected, next);
+            s = next;
+        }
+        return s;
+    }
+
+    // 在序号 ticket 的槽位上构造元素, 槽位已被出队者跳过时返回 false
+    template <class T>
+    template <class ...Args>
+    bool concurrent_queue<T>::put(size_type ticket, Args&& ...args)
+    {
+        segment *s = find_segment(tail_.load(), ticket);
+        slot &sl = s->slots[ticket - s->base];
+        unsigned char expected = slot_empty;
+        if (!sl.state.compare_exchange_strong(expected, slot_writing, std::memory_order_acquire)) {
+            finish_slot(s);
+            return false;
+        }
+        try {
+            mystl::construct(sl.value(), mystl::forward<Args>(args)...);
+        }
+        catch (...) {
+            sl.state.store(slot_abandoned, std::memory_order_release);
+            throw;
+        }
+        sl.state.store(slot_ready, std::memory_order_release);
+        return true;
+    }
+
+    // 取走序号 ticket 的槽位上的元素并写入 *result, 槽位没有元素时返回 false
+    template <class T>
+    template <class OIter>
+    bool concurrent_queue<T>::take(size_type ticket, OIter &result)
+    {
+        segment *s = find_segment(head_.load(), ticket);
+        slot &sl = s->slots[ticket - s->base];
+        unsigned char state = slot_empty;
+        if (sl.state.compare_exchange_strong(state, slot_skipped, std::memory_order_acquire))
+            return false;
+        // 入队者已领到该槽位, 等它写完
+        while (state == slot_writing)
+            state = sl.state.load(std::memory_order_acquire);
+        if (state == slot_ready) {
+            T *p = sl.value();
+            try {
+                *result = mystl::move(*p);
+            }
+            catch (...) {
+                // 该序号已无人能再取, 元素随之丢弃
+                mystl::destroy(p);
+                sl.state.store(slot_done, std::memory_order_relaxed);
+                finish_slot(s);
+                throw;
+            }
+            ++result;
+            mystl::destroy(p);
+            sl.state.store(slot_done, std::memory_order_relaxed);
+            finish_slot(s);
+            return true;
+        }
+        finish_slot(s);
+        return false;
+    }
+
+    // 入队者放弃已领取的序号; 只有入队者会写入 slot_abandoned, 槽位已是该状态说明已经放弃过
+    template <class T>
+    void concurrent_queue<T>::abandon(size_type ticket)
+    {
+        segment *s = find_segment(tail_.load(), ticket);
+        slot &sl = s->slots[ticket - s->base];
+        unsigned char expected = slot_empty;
+        if (!sl.state.compare_exchange_strong(expected, slot_abandoned, std::memory_order_release) &&
+            expected != slot_abandoned)
+            finish_slot(s);
+    }
+
+    // 双方都访问过一个槽位后调用, 整块完成时尝试推进 head_
+    template <class T>
+    void concurrent_queue<T>::finish_slot(segment *s) noexcept
+    {
+        if (s->finished.fetch_add(1) + 1 == segment_size)
+            advance_head();
+    }
+
+    // 摘除链表头部已完成的块
+    template <class T>
+    void concurrent_queue<T>::advance_head() noexcept
+    {
+        segment *h = head_.load();
+        while (h->finished.load() == segment_size) {
+            segment *next = h->next.load();
+            if (next == nullptr)
+                return;
+            if (!head_.compare_exchange_strong(h, next))
+                continue;
+            segment *expected = h;
+            tail_.compare_exchange_strong(expected, next);
+            segment *top = retired_.load();
+            do {
+                h->retire_next = top;
+            } while (!retired_.compare_exchange_weak(top, h));
+            h = next;
+        }
+        reclaim();
+    }
+
+    // 上一代的活跃线程都已退出时, 释放 stage_ 中的块, 把新摘除的块移入 stage_ 并进入下一代
+    template <class T>
+    void concurrent_queue<T>::reclaim() noexcept
+    {
+        if (retired_.load() == nullptr && stage_.load(std::memory_order_relaxed) == nullptr)
+            return;
+        if (reclaiming_.test_and_set(std::memory_order_acquire))
+            return;
+        const unsigned e = epoch_.load();
+        if (active_[(e + 1) & 1].load() == 0) {
+            for (segment *s = stage_.load(std::memory_order_relaxed); s != nullptr; ) {
+                segment *next = s->retire_next;
+                destroy_segment(s);
+                s = next;
+            }
+            stage_.store(retired_.exchange(nullptr), std::memory_order_relaxed);
+            epoch_.store(e + 1);
+        }
+        reclaiming_.clear(std::memory_order_release);
+    }
+};
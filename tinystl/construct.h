@@ -44,6 +44,9 @@ namespace mystl {
         }
     }
 
+    template <class Ty>
+    void destroy(Ty *pointer);
+
     template <class ForwardIter>
     void destroy_aux(ForwardIter , ForwardIter , std::true_type) { }
 
@@ -0,0 +1,501 @@
+#pragma once
+
+/*
+ * 模板类 cow_deque
+ * 写时复制的双端队列: 与 deque 一样按定长缓冲区存放元素, 但缓冲区带引用计数, 可被多个 cow_deque 共享.
+ * 复制一个 cow_deque 只复制缓冲区指针并增加计数, 代价 O(块数);
+ * 第一次修改某个被共享的缓冲区时才把它复制一份. 共享中的缓冲区从不被修改,
+ * 因此持有同一批缓冲区的不同 cow_deque 可以在不同线程中使用
+ */
+
+#include <atomic>
+#include <initializer_list>
+#include <type_traits>
+
+#include "allocator.h"
+#include "construct.h"
+#include "deque.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "util.h"
+
+namespace mystl {
+    template <class T>
+    class cow_deque;
+
+    // cow_deque 的迭代器: 以容器指针 + 下标表示, 随机访问; 经非 const 迭代器访问元素会使所在块独占
+    template <class T, class Ref, class Ptr>
+    struct cow_deque_iterator : public iterator<random_access_iterator_tag, T> {
+        typedef cow_deque_iterator<T, T&, T*>              iterator;
+        typedef cow_deque_iterator<T, const T&, const T*>  const_iterator;
+        typedef cow_deque_iterator                         self;
+
+        typedef T          value_type;
+        typedef Ptr        pointer;
+        typedef Ref        reference;
+        typedef size_t     size_type;
+        typedef ptrdiff_t  difference_type;
+
+        typedef typename std::conditional<std::is_const<typename std::remove_reference<Ref>::type>::value,
+            const cow_deque<T>*, cow_deque<T>*>::type container_pointer;
+
+        container_pointer c;     // 所属容器
+        size_type         index; // 元素下标
+
+        cow_deque_iterator() noexcept : c(nullptr), index(0) {}
+        cow_deque_iterator(container_pointer x, size_type i) noexcept : c(x), index(i) {}
+        cow_deque_iterator(const iterator &rhs) noexcept : c(rhs.c), index(rhs.index) {}
+
+        self& operator=(const iterator &rhs) noexcept
+        {
+            c = rhs.c;
+            index = rhs.index;
+            return *this;
+        }
+
+        reference operator*()  const { return (*c)[index]; }
+        pointer   operator->() const { return &(operator*()); }
+
+        difference_type operator-(const self &x) const
+        {
+            return static_cast<difference_type>(index) - static_cast<difference_type>(x.index);
+        }
+
+        self& operator++() { ++index; return *this; }
+        self  operator++(int)
+        {
+            self tmp = *this;
+            ++index;
+            return tmp;
+        }
+        self& operator--() { --index; return *this; }
+        self  operator--(int)
+        {
+            self tmp = *this;
+            --index;
+            return tmp;
+        }
+
+        self& operator+=(difference_type n) { index += n; return *this; }
+        self  operator+(difference_type n) const
+        {
+            self tmp = *this;
+            return tmp += n;
+        }
+        self& operator-=(difference_type n) { return *this += -n; }
+        self  operator-(difference_type n) const
+        {
+            self tmp = *this;
+            return tmp -= n;
+        }
+
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        bool operator==(const self &rhs) const { return index == rhs.index; }
+        bool operator!=(const self &rhs) const { return index != rhs.index; }
+        bool operator< (const self &rhs) const { return index < rhs.index; }
+        bool operator> (const self &rhs) const { return rhs < *this; }
+        bool operator<=(const self &rhs) const { return !(rhs < *this); }
+        bool operator>=(const self &rhs) const { return !(*this < rhs); }
+    };
+
+    // 模板类 cow_deque
+    template <class T>
+    class cow_deque {
+    public:
+        typedef T                                        value_type;
+        typedef T*                                       pointer;
+        typedef const T*                                 const_pointer;
+        typedef T&                                       reference;
+        typedef const T&                                 const_reference;
+        typedef size_t                                   size_type;
+        typedef ptrdiff_t                                difference_type;
+
+        typedef cow_deque_iterator<T, T&, T*>             iterator;
+        typedef cow_deque_iterator<T, const T&, const T*> const_iterator;
+        typedef mystl::reverse_iterator<iterator>        reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+        static const size_type buffer_size = deque_buf_size<T>::value;
+
+    private:
+        typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type slot_type;
+
+        // 带引用计数的缓冲区, [lo, hi) 为已构造的槽位; 各持有者看到的元素都在其中
+        struct block {
+            std::atomic<size_type> refs;
+            size_type              lo;
+            size_type              hi;
+            slot_type              slots[buffer_size];
+
+            T* at(size_type i) noexcept { return reinterpret_cast<T*>(slots + i); }
+        };
+
+        typedef mystl::allocator<block> block_allocator;
+
+        mystl::deque<block*> blocks_;
+        size_type            head_;   // 第一个元素在第一块中的槽位
+        size_type            size_;
+
+    public:
+        // 构造、复制、移动、析构函数
+        cow_deque() noexcept
+            : head_(0), size_(0)
+        {
+        }
+
+        template <class IIter, typename std::enable_if<
+            mystl::is_input_iterator<IIter>::value, int>::type = 0>
+        cow_deque(IIter first, IIter last)
+            : cow_deque()
+        {
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+
+        cow_deque(std::initializer_list<value_type> ilist)
+            : cow_deque(ilist.begin(), ilist.end())
+        {
+        }
+
+        // 只共享缓冲区, 不复制元素
+        cow_deque(const cow_deque &rhs)
+            : blocks_(rhs.blocks_), head_(rhs.head_), size_(rhs.size_)
+        {
+            for (size_type i = 0; i < blocks_.size(); ++i)
+                blocks_[i]->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        cow_deque(cow_deque &&rhs) noexcept
+            : blocks_(mystl::move(rhs.blocks_)), head_(rhs.head_), size_(rhs.size_)
+        {
+            rhs.head_ = rhs.size_ = 0;
+        }
+
+        cow_deque& operator=(const cow_deque &rhs)
+        {
+            if (this != &rhs) {
+                cow_deque tmp(rhs);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        cow_deque& operator=(cow_deque &&rhs) noexcept
+        {
+            if (this != &rhs) {
+                cow_deque tmp(mystl::move(rhs));
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        ~cow_deque()
+        {
+            clear();
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator               begin()         noexcept { return iterator(this, 0); }
+        const_iterator         begin()   const noexcept { return const_iterator(this, 0); }
+        iterator               end()           noexcept { return iterator(this, size_); }
+        const_iterator         end()     const noexcept { return const_iterator(this, size_); }
+
+        reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator         cbegin()  const noexcept { return begin(); }
+        const_iterator         cend()    const noexcept { return end(); }
+
+        // 容量相关操作
+        bool      empty()  const noexcept { return size_ == 0; }
+        size_type size()   const noexcept { return size_; }
+
+        // 与其它 cow_deque 共享的缓冲区个数
+        size_type shared_blocks() const noexcept
+        {
+            size_type n = 0;
+            for (size_type i = 0; i < blocks_.size(); ++i)
+                n += blocks_[i]->refs.load(std::memory_order_relaxed) > 1;
+            return n;
+        }
+
+        // 访问元素相关操作; 非 const 版本会先使元素所在块独占
+        const_reference operator[](size_type n) const
+        {
+            MYSTL_DEBUG(n < size_);
+            const size_type p = head_ + n;
+            return *blocks_[p / buffer_size]->at(p % buffer_size);
+        }
+        reference       operator[](size_type n)
+        {
+            MYSTL_DEBUG(n < size_);
+            const size_type p = head_ + n;
+            return *make_unique(p / buffer_size)->at(p % buffer_size);
+        }
+
+        const_reference at(size_type n) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size_), "cow_deque<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+        reference       at(size_type n)
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size_), "cow_deque<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        const_reference front() const { MYSTL_DEBUG(!empty()); return (*this)[0]; }
+        reference       front()       { MYSTL_DEBUG(!empty()); return (*this)[0]; }
+        const_reference back()  const { MYSTL_DEBUG(!empty()); return (*this)[size_ - 1]; }
+        reference       back()        { MYSTL_DEBUG(!empty()); return (*this)[size_ - 1]; }
+
+        // 修改容器相关操作
+        template <class ...Args>
+        void      emplace_back(Args&& ...args);
+        template <class ...Args>
+        void      emplace_front(Args&& ...args);
+
+        void      push_back(const value_type &value)  { emplace_back(value); }
+        void      push_back(value_type &&value)       { emplace_back(mystl::move(value)); }
+        void      push_front(const value_type &value) { emplace_front(value); }
+        void      push_front(value_type &&value)      { emplace_front(mystl::move(value)); }
+
+        // 弹出共享块中的元素只缩小可见范围, 元素随块一起释放
+        void      pop_front();
+        void      pop_back();
+        void      clear() noexcept;
+
+        void      swap(cow_deque &rhs) noexcept
+        {
+            blocks_.swap(rhs.blocks_);
+            mystl::swap(head_, rhs.head_);
+            mystl::swap(size_, rhs.size_);
+        }
+
+    private:
+        // helper functions
+        block*    create_block(size_type pos);
+        void      release(block *b) noexcept;
+        block*    make_unique(size_type idx);
+        void      view_of(size_type idx, size_type &lo, size_type &hi) const noexcept;
+    };
+
+    /*****************************************************************************************/
+
+    template <class T>
+    template <class ...Args>
+    void cow_deque<T>::emplace_back(Args&& ...args)
+    {
+        const size_type tail = head_ + size_;
+        const bool grow = tail == blocks_.size() * buffer_size;
+        if (grow) {
+            block *b = create_block(0);
+            try {
+                blocks_.push_back(b);
+            }
+            catch (...) {
+                release(b);
+                throw;
+            }
+        }
+        try {
+            block *b = make_unique(blocks_.size() - 1);
+            const size_type s = tail % buffer_size;
+            mystl::construct(b->at(s), mystl::forward<Args>(args)...);
+            b->hi = s + 1;
+        }
+        catch (...) {
+            if (grow) {
+                release(blocks_.back());
+                blocks_.pop_back();
+            }
+            throw;
+        }
+        ++size_;
+    }
+
+    template <class T>
+    template <class ...Args>
+    void cow_deque<T>::emplace_front(Args&& ...args)
+    {
+        const bool grow = head_ == 0;
+        if (grow) {
+            block *b = create_block(buffer_size);
+            try {
+                blocks_.push_front(b);
+            }
+            catch (...) {
+                release(b);
+                throw;
+            }
+            head_ = buffer_size;
+        }
+        try {
+            block *b = make_unique(0);
+            mystl::construct(b->at(head_ - 1), mystl::forward<Args>(args)...);
+            b->lo = head_ - 1;
+        }
+        catch (...) {
+            if (grow) {
+                release(blocks_.front());
+                blocks_.pop_front();
+                head_ = 0;
+            }
+            throw;
+        }
+        --head_;
+        ++size_;
+    }
+
+    template <class T>
+    void cow_deque<T>::pop_front()
+    {
+        MYSTL_DEBUG(!empty());
+        block *b = blocks_.front();
+        if (b->refs.load(std::memory_order_acquire) == 1) {
+            b = make_unique(0);
+            mystl::destroy(b->at(head_));
+            b->lo = head_ + 1;
+        }
+        ++head_;
+        --size_;
+        if (size_ == 0) {
+            clear();
+        }
+        else if (head_ == buffer_size) {
+            release(b);
+            blocks_.pop_front();
+            head_ = 0;
+        }
+    }
+
+    template <class T>
+    void cow_deque<T>::pop_back()
+    {
+        MYSTL_DEBUG(!empty());
+        const size_type s = (head_ + size_ - 1) % buffer_size;
+        block *b = blocks_.back();
+        if (b->refs.load(std::memory_order_acquire) == 1) {
+            b = make_unique(blocks_.size() - 1);
+            mystl::destroy(b->at(s));
+            b->hi = s;
+        }
+        --size_;
+        if (size_ == 0) {
+            clear();
+        }
+        else if (s == 0) {
+            release(b);
+            blocks_.pop_back();
+        }
+    }
+
+    template <class T>
+    void cow_deque<T>::clear() noexcept
+    {
+        while (!blocks_.empty()) {
+            release(blocks_.back());
+            blocks_.pop_back();
+        }
+        head_ = size_ = 0;
+    }
+
+    /*****************************************************************************************/
+    // helper function
+
+    // 新块没有已构造的槽位, pos 为第一个元素将要放入的位置的边界
+    template <class T>
+    typename cow_deque<T>::block* cow_deque<T>::create_block(size_type pos)
+    {
+        block *b = block_allocator::allocate(1);
+        ::new (static_cast<void*>(&b->refs)) std::atomic<size_type>(1);
+        b->lo = b->hi = pos;
+        return b;
+    }
+
+    // 最后一个持有者负责析构元素并释放内存
+    template <class T>
+    void cow_deque<T>::release(block *b) noexcept
+    {
+        if (b->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+        for (size_type i = b->lo; i < b->hi; ++i)
+            mystl::destroy(b->at(i));
+        block_allocator::deallocate(b, 1);
+    }
+
+    // 第 idx 块中本容器可见的槽位 [lo, hi)
+    template <class T>
+    void cow_deque<T>::view_of(size_type idx, size_type &lo, size_type &hi) const noexcept
+    {
+        const size_type first = idx * buffer_size;
+        const size_type vb = head_ > first ? head_ : first;
+        const size_type ve = head_ + size_ < first + buffer_size ? head_ + size_ : first + buffer_size;
+        lo = vb - first;
+        hi = ve > vb ? ve - first : lo;
+    }
+
+    // 使第 idx 块只属于本容器, 且已构造的槽位恰为可见范围
+    template <class T>
+    typename cow_deque<T>::block* cow_deque<T>::make_unique(size_type idx)
+    {
+        block *b = blocks_[idx];
+        size_type lo, hi;
+        view_of(idx, lo, hi);
+        if (b->refs.load(std::memory_order_acquire) == 1) {
+            // 独占: 析构其它持有者留下、本容器已看不到的元素
+            for (size_type i = b->lo; i < lo; ++i)
+                mystl::destroy(b->at(i));
+            for (size_type i = hi; i < b->hi; ++i)
+                mystl::destroy(b->at(i));
+            b->lo = lo;
+            b->hi = hi;
+            return b;
+        }
+        block *copy = create_block(lo);
+        size_type i = lo;
+        try {
+            for (; i < hi; ++i)
+                mystl::construct(copy->at(i), *b->at(i));
+        }
+        catch (...) {
+            copy->hi = i;
+            release(copy);
+            throw;
+        }
+        copy->hi = hi;
+        blocks_[idx] = copy;
+        release(b);
+        return copy;
+    }
+
+    // 重载比较操作符
+    template <class T>
+    bool operator==(const cow_deque<T> &lhs, const cow_deque<T> &rhs)
+    {
+        if (lhs.size() != rhs.size())
+            return false;
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            if (!(lhs[i] == rhs[i]))
+                return false;
+        }
+        return true;
+    }
+
+    template <class T>
+    bool operator!=(const cow_deque<T> &lhs, const cow_deque<T> &rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    // 重载 mystl 的 swap
+    template <class T>
+    void swap(cow_deque<T> &lhs, cow_deque<T> &rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+};
@@ -30,17 +30,27 @@ namespace mystl {
     #define DEQUE_MAP_INIT_SIZE 8
     #endif
 
-    template <class T>
+    // 每个 deque 最多缓存的空闲缓冲区个数, 为 0 时不缓存
+    #ifndef DEQUE_SPARE_BLOCKS
+    #define DEQUE_SPARE_BLOCKS 4
+    #endif
+
+    // 缓冲区大小策略
+    // BlockBytes 为 0 时使用默认策略: 元素小于 256 字节时每个缓冲区 4096 字节, 否则每个缓冲区 16 个元素
+    // BlockBytes 不为 0 时每个缓冲区约 BlockBytes 字节, 至少容纳一个元素
+    template <class T, size_t BlockBytes = 0>
     struct deque_buf_size {
-        static constexpr size_t value = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+        static constexpr size_t value = BlockBytes != 0
+            ? (BlockBytes < sizeof(T) ? 1 : BlockBytes / sizeof(T))
+            : (sizeof(T) < 256 ? 4096 / sizeof(T) : 16);
     };
 
     // deque 迭代器
-    template <class T, class Ref, class Ptr>
+    template <class T, class Ref, class Ptr, size_t BlockBytes = 0>
     struct deque_iterator : public iterator<random_access_iterator_tag, T> {
-        typedef deque_iterator<T, T&, T*>             iterator;
-        typedef deque_iterator<T, const T&, const T*> const_iterator;
-        typedef deque_iterator                        self;
+        typedef deque_iterator<T, T&, T*, BlockBytes>             iterator;
+        typedef deque_iterator<T, const T&, const T*, BlockBytes> const_iterator;
+        typedef deque_iterator                                    self;
 
         typedef T          value_type;
         typedef Ptr        pointer;
@@ -50,7 +60,7 @@ namespace mystl {
         typedef T*         value_pointer;
         typedef T**        map_pointer;
 
-        static const  size_type buffer_size = deque_buf_size<T>::value;
+        static const  size_type buffer_size = deque_buf_size<T, BlockBytes>::value;
 
         // 迭代器数据成员
         value_pointer cur;      // 缓冲区当前元素
@@ -111,6 +121,9 @@ namespace mystl {
 
         difference_type operator-(const self &x) const
         {
+            // 同一缓冲区内 (包括未分配空间的空 deque 的空迭代器) 直接相减
+            if (node == x.node)
+                return cur - x.cur;
             return static_cast<difference_type>(buffer_size) * (node - x.node - 1)
                      + (cur - first) + (x.last - x.cur);
         }
@@ -203,8 +216,64 @@ namespace mystl {
         bool operator>=(const self &rhs) const { return !(*this < rhs); }
     };
 
+    // deque 分段迭代器
+    // 每次解引用得到一个缓冲区内的连续元素 (首地址, 个数), 便于对整段做向量化的循环
+    template <class T, class Ptr, size_t BlockBytes = 0>
+    struct deque_segment_iterator
+        : public iterator<forward_iterator_tag, mystl::pair<Ptr, size_t>> {
+        typedef deque_segment_iterator    self;
+        typedef mystl::pair<Ptr, size_t>  value_type;
+        typedef T**                       map_pointer;
+
+        static const size_t buffer_size = deque_buf_size<T, BlockBytes>::value;
+
+        map_pointer node;      // 当前段所在节点
+        Ptr         cur;       // 当前段的起点
+        map_pointer end_node;  // 最后一个元素所在节点
+        Ptr         end_cur;   // 最后一个元素的下一位置
+
+        deque_segment_iterator() noexcept
+            : node(nullptr), cur(nullptr), end_node(nullptr), end_cur(nullptr) {}
+
+        deque_segment_iterator(map_pointer n, Ptr c, map_pointer en, Ptr ec) noexcept
+            : node(n), cur(c), end_node(en), end_cur(ec) {}
+
+        value_type operator*() const
+        {
+            Ptr last = node == end_node ? end_cur : *node + buffer_size;
+            return value_type(cur, static_cast<size_t>(last - cur));
+        }
+
+        self& operator++()
+        {
+            ++node;
+            cur = node <= end_node ? *node : nullptr;
+            return *this;
+        }
+        self operator++(int)
+        {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const self &rhs) const { return node == rhs.node; }
+        bool operator!=(const self &rhs) const { return node != rhs.node; }
+    };
+
+    // 分段迭代器构成的区间, 可用于范围 for
+    template <class SegIter>
+    struct deque_segment_range {
+        SegIter first;
+        SegIter last;
+
+        SegIter begin() const { return first; }
+        SegIter end()   const { return last; }
+    };
+
     // 模板类 deque
-    template <class T>
+    // 参数一代表数据类型, 参数二代表每个缓冲区的字节数, 缺省为 0 即使用 deque_buf_size 的默认策略
+    template <class T, size_t BlockBytes = 0>
     class deque {
     public:
         // typedef mystl::alloc                             allocator_type;
@@ -225,26 +294,38 @@ namespace mystl {
         typedef pointer*                                 map_pointer;
         typedef const_pointer*                           const_map_pointer;
         
-        typedef deque_iterator<T, T&, T*>               iterator;
-        typedef deque_iterator<T, const T&, const T*>   const_iterator;
+        typedef deque_iterator<T, T&, T*, BlockBytes>             iterator;
+        typedef deque_iterator<T, const T&, const T*, BlockBytes> const_iterator;
         typedef mystl::reverse_iterator<iterator>       reverse_iterator;
         typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        typedef deque_segment_iterator<T, T*, BlockBytes>        segment_iterator;
+        typedef deque_segment_iterator<T, const T*, BlockBytes>  const_segment_iterator;
+        typedef deque_segment_range<segment_iterator>            segment_range;
+        typedef deque_segment_range<const_segment_iterator>      const_segment_range;
         
         allocator_type get_allocator() { return allocator_type(); }
         // 一个缓冲区元素的个数
-        static const size_type buffer_size = deque_buf_size<T>::value;
+        static const size_type buffer_size = deque_buf_size<T, BlockBytes>::value;
+        // 最多缓存的空闲缓冲区个数
+        static const size_type spare_capacity = DEQUE_SPARE_BLOCKS;
         
     private:
         iterator       begin_;    // 指向第一个节点
         iterator       end_;      // 指向最后一个节点
-        map_pointer    map_;      // 指向一块 map, map 中的每个元素都是一个指针，指向缓冲区
-        size_type      map_size_; // map 中可存指针的数目
+        map_pointer    map_ = nullptr;  // 指向一块 map, map 中的每个元素都是一个指针，指向缓冲区
+        size_type      map_size_ = 0;   // map 中可存指针的数目
+
+        // 空闲缓冲区缓存: 释放的缓冲区先放在这里, 申请缓冲区时优先取用,
+        // 使得头删尾插交替进行的队列在稳定状态下不再调用分配器
+        pointer        spare_[spare_capacity > 0 ? spare_capacity : 1];
+        size_type      spare_count_ = 0;
 
     public:
         // 构造、复制、移动、析构函数
-        deque()
+        // 空 deque 不申请 map 与缓冲区, map_ 为空, begin_ 与 end_ 为空迭代器, 第一次插入时再分配
+        deque() noexcept
         {
-            fill_init(0, value_type());
         }
 
         explicit deque(size_type n)
@@ -280,6 +361,8 @@ namespace mystl {
              map_(rhs.map_),
              map_size_(rhs.map_size_)
         {
+            rhs.begin_ = iterator();
+            rhs.end_ = iterator();
             rhs.map_ = nullptr;
             rhs.map_size_ = 0;
         }
@@ -296,14 +379,7 @@ namespace mystl {
 
         ~deque()
         {
-            if (map_ != nullptr)
-            {
-                clear();
-                data_allocator::deallocate(*begin_.node, buffer_size);
-                *begin_.node = nullptr;
-                map_allocator::deallocate(map_, map_size_);
-                map_ = nullptr;
-            }
+            destroy_storage();
         }
     public:
         // 迭代器相关操作
@@ -334,6 +410,23 @@ namespace mystl {
         const_reverse_iterator  crend()    const  noexcept
         { return rend(); }
 
+        // 按缓冲区分段遍历, 每段为 mystl::pair<T*, size_t>
+        segment_range           segments()        noexcept
+        { return segment_range{segment_begin<segment_iterator>(), segment_end<segment_iterator>()}; }
+        const_segment_range     segments()  const noexcept
+        {
+            return const_segment_range{segment_begin<const_segment_iterator>(),
+                                       segment_end<const_segment_iterator>()};
+        }
+
+        // 对每一段连续元素调用 f(T* p, size_t n), prefetch 为 true 时处理当前段前预取下一个缓冲区
+        template <class Func>
+        Func                    for_each_segment(Func f, bool prefetch = false)
+        { return for_each_segment_aux(segments(), f, prefetch); }
+        template <class Func>
+        Func                    for_each_segment(Func f, bool prefetch = false) const
+        { return for_each_segment_aux(segments(), f, prefetch); }
+
         // 内存分配释放相关操作
         bool      empty()        const noexcept  { return begin() == end(); }
         size_type size()         const noexcept  { return end_ - begin_; }
@@ -342,6 +435,15 @@ namespace mystl {
         void      resize(size_type new_size, const value_type &value);
         void      shrink_to_fit()      noexcept;
 
+        // 预留空间: 一次申请好 map 与缓冲区, 之后 n 次 push_back / push_front 不再申请内存
+        void      reserve_back(size_type n)
+        { if (capacity_back() < n) require_capacity(n, false); }
+        void      reserve_front(size_type n)
+        { if (capacity_front() < n) require_capacity(n, true); }
+        size_type capacity_back()      const noexcept;
+        size_type capacity_front()     const noexcept;
+        size_type spare_blocks() const noexcept  { return spare_count_; }
+
         // 访问元素相关操作
         reference               operator[](size_type n)
         {
@@ -424,6 +526,14 @@ namespace mystl {
         void        pop_front();
         void        pop_back();
 
+        // 批量删除: 按缓冲区整块析构 (平凡类型无需析构), 整块释放缓冲区
+        void        pop_front_n(size_type n);
+        void        pop_back_n(size_type n);
+
+        // 将头部至多 n 个元素移动到 result, 并从容器中删除, 返回输出的尾部
+        template <class OutputIter>
+        OutputIter  drain_front(size_type n, OutputIter result);
+
         // insert
         iterator    insert(iterator position, const value_type &value);
         iterator    insert(iterator position, value_type &&value);
@@ -433,6 +543,21 @@ namespace mystl {
         void        insert(iterator position, IIter first, IIter last)
         { insert_dispatch(position, first, last, iterator_category(first)); }
 
+        // append / prepend
+        // 批量在尾部 / 头部插入: 只调用一次 require_capacity, 然后按缓冲区整块构造,
+        // 平凡可复制的元素从连续区间拷贝时整块 memmove
+        template <class IIter, typename std::enable_if<
+            mystl::is_input_iterator<IIter>::value, int>::type = 0>
+        void        append(IIter first, IIter last)
+        { append_dispatch(first, last, iterator_category(first)); }
+        void        append(const_pointer first, size_type n)  { append_n(first, n); }
+
+        template <class IIter, typename std::enable_if<
+            mystl::is_input_iterator<IIter>::value, int>::type = 0>
+        void        prepend(IIter first, IIter last)
+        { prepend_dispatch(first, last, iterator_category(first)); }
+        void        prepend(const_pointer first, size_type n) { prepend_n(first, n); }
+
         // erase / clear
         iterator    erase(iterator position);
         iterator    erase(iterator first, iterator last);
@@ -444,11 +569,40 @@ namespace mystl {
     private:
         // helper functions 对外的接口函数使用
 
+        // segments
+        // 最后一个缓冲区为空时不产生空段, 空 deque 的分段区间为空
+        template <class SegIter>
+        SegIter     segment_begin() const noexcept
+        { return SegIter(begin_.node, begin_.cur, end_.node, end_.cur); }
+        template <class SegIter>
+        SegIter     segment_end()   const noexcept
+        {
+            map_pointer last = (empty() || end_.cur == end_.first) ? end_.node : end_.node + 1;
+            return SegIter(last, nullptr, end_.node, end_.cur);
+        }
+        template <class Range, class Func>
+        Func        for_each_segment_aux(Range r, Func f, bool prefetch) const
+        {
+            for (auto it = r.begin(); it != r.end(); ++it) {
+                if (prefetch && it.node != end_.node)
+                    MYSTL_PREFETCH(*(it.node + 1));
+                auto seg = *it;
+                f(seg.first, seg.second);
+            }
+            return f;
+        }
+
         // create node / destroy node
         map_pointer create_map(size_type size);
         void        create_buffer(map_pointer nstart, map_pointer nfinish);
         void        destroy_buffer(map_pointer nstart, map_pointer nfinish);
 
+        // 单个缓冲区的申请与归还, 经过空闲缓冲区缓存
+        pointer     allocate_buffer();
+        void        deallocate_buffer(pointer buf) noexcept;
+        void        release_spare() noexcept;
+        void        destroy_storage() noexcept;
+
         // initialize
         void        map_init(size_type nelem);
         void        fill_init(size_type n, const value_type &value);
@@ -475,16 +629,35 @@ namespace mystl {
         template <class FIter>
         void        insert_dispatch(iterator, FIter, FIter, forward_iterator_tag);
 
+        // append / prepend
+        template <class FIter>
+        static void copy_chunk(FIter &first, size_type n, pointer result);
+        template <class Ref, class Ptr, size_t B>
+        static void copy_chunk(deque_iterator<T, Ref, Ptr, B> &first, size_type n, pointer result);
+        template <class FIter>
+        void        append_n(FIter first, size_type n);
+        template <class FIter>
+        void        prepend_n(FIter first, size_type n);
+        template <class IIter>
+        void        append_dispatch(IIter, IIter, input_iterator_tag);
+        template <class FIter>
+        void        append_dispatch(FIter, FIter, forward_iterator_tag);
+        template <class IIter>
+        void        prepend_dispatch(IIter, IIter, input_iterator_tag);
+        template <class FIter>
+        void        prepend_dispatch(FIter, FIter, forward_iterator_tag);
+
         // reallocate
         void        require_capacity(size_type n, bool front);
+        map_pointer reallocate_map(size_type need, bool front);
         void        reallocate_map_at_front(size_type need);
         void        reallocate_map_at_back(size_type need);
     };
 
     /************************************************************************************************/
     // 复制赋值运算符
-    template <class T>
-    deque<T>& deque<T>::operator=(const deque &rhs)
+    template <class T, size_t BlockBytes>
+    deque<T, BlockBytes>& deque<T, BlockBytes>::operator=(const deque &rhs)
     {
         if (this != &rhs) {
             const auto len = size();
@@ -502,23 +675,21 @@ namespace mystl {
     }
 
     // 移动赋值运算符
-    template <class T>
-    deque<T>& deque<T>::operator=(deque &&rhs)
+    template <class T, size_t BlockBytes>
+    deque<T, BlockBytes>& deque<T, BlockBytes>::operator=(deque &&rhs)
     {
-        clear();
-        begin_ = mystl::move(rhs.begin_);
-        end_   = mystl::move(rhs.end_);
-        map_   = rhs.map_;
-        map_size_ = rhs.map_size_;
-        rhs.map = nullptr;
-        rhs.map_size_ = 0;
+        // 原来的实现没有释放自身的 map 与缓冲区, 且 rhs.map 无法通过编译
+        if (this != &rhs) {
+            deque tmp(mystl::move(rhs));
+            swap(tmp);
+        }
 
         return *this;
     }
 
     // 调整容器大小
-    template <class T>
-    void deque<T>::resize(size_type new_size, const value_type &value)
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::resize(size_type new_size, const value_type &value)
     {
         const auto len = size();
         if (new_size < len)
@@ -530,10 +701,15 @@ namespace mystl {
         }
     }
 
-    // 释放没在使用的缓冲区
-    template <class T>
-    void deque<T>::shrink_to_fit() noexcept
+    // 释放没在使用的缓冲区, 包括空闲缓冲区缓存
+    // 空 deque 回到不占用堆内存的状态
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::shrink_to_fit() noexcept
     {
+        if (empty()) {
+            destroy_storage();
+            return;
+        }
         for (auto cur = map_; cur < begin_.node; ++cur) {
             data_allocator::deallocate(*cur, buffer_size);
             *cur = nullptr;
@@ -542,12 +718,37 @@ namespace mystl {
             data_allocator::deallocate(*cur, buffer_size);
             *cur = nullptr;
         }
+        release_spare();
+    }
+
+    // 不申请内存还能在尾部插入的元素个数
+    template <class T, size_t BlockBytes>
+    typename deque<T, BlockBytes>::size_type deque<T, BlockBytes>::capacity_back() const noexcept
+    {
+        if (map_ == nullptr)
+            return 0;
+        size_type n = end_.last - end_.cur - 1;
+        for (auto cur = end_.node + 1; cur < map_ + map_size_ && *cur != nullptr; ++cur)
+            n += buffer_size;
+        return n;
+    }
+
+    // 不申请内存还能在头部插入的元素个数
+    template <class T, size_t BlockBytes>
+    typename deque<T, BlockBytes>::size_type deque<T, BlockBytes>::capacity_front() const noexcept
+    {
+        if (map_ == nullptr)
+            return 0;
+        size_type n = begin_.cur - begin_.first;
+        for (auto cur = begin_.node; cur != map_ && *(cur - 1) != nullptr; --cur)
+            n += buffer_size;
+        return n;
     }
 
     // 在头部构建元素
-    template <class T>
+    template <class T, size_t BlockBytes>
     template <class ...Args>
-    void deque<T>::emplace_front(Args&& ...args)
+    void deque<T, BlockBytes>::emplace_front(Args&& ...args)
     {
         if (begin_.cur != begin_.first) {
             // data_allocator::construct(begin_.cur - 1, mystl::forward<Args>(args)...);
@@ -569,11 +770,11 @@ namespace mystl {
     }
 
     // 在尾部构建元素
-    template <class T>
+    template <class T, size_t BlockBytes>
     template <class ...Args>
-    void deque<T>::emplace_back(Args&& ...args)
+    void deque<T, BlockBytes>::emplace_back(Args&& ...args)
     {
-        if (end_.cur != end_.last - 1) {
+        if (end_.last - end_.cur > 1) {
             mystl::construct(end_.cur, mystl::forward<Args>(args)...);
             ++end_.cur;
         }
@@ -585,9 +786,9 @@ namespace mystl {
     }
 
     // 在 pos 位置前面构建元素
-    template <class T>
+    template <class T, size_t BlockBytes>
     template <class ...Args>
-    typename deque<T>::iterator deque<T>::emplace(iterator pos, Args&& ...args)
+    typename deque<T, BlockBytes>::iterator deque<T, BlockBytes>::emplace(iterator pos, Args&& ...args)
     {
         if (pos.cur == begin_.cur) {
             emplace_front(mystl::forward<Args>(args)...);
@@ -602,8 +803,8 @@ namespace mystl {
     }
 
     // 在头部插入元素
-    template <class T>
-    void deque<T>::push_front(const value_type &value)
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::push_front(const value_type &value)
     {
         if (begin_.cur != begin_.first) {
             mystl::construct(begin_.cur - 1, value);
@@ -623,10 +824,10 @@ namespace mystl {
     }
 
     // 在尾部插入元素
-    template <class T>
-    void deque<T>::push_back(const value_type &value)
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::push_back(const value_type &value)
     {
-        if (end_.cur != end_.last  - 1) {
+        if (end_.last - end_.cur > 1) {
             mystl::construct(end_.cur, value);
             ++end_.cur;
         }
@@ -638,8 +839,8 @@ namespace mystl {
     }
 
     // 取出头部元素
-    template <class T>
-    void deque<T>::pop_front()
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::pop_front()
     {
         MYSTL_DEBUG(!empty());
         if (begin_.cur != begin_.last - 1) {
@@ -649,13 +850,13 @@ namespace mystl {
         else {
             mystl::destroy(begin_.cur);
             ++begin_;
-            detroy_buffer(begin_.node - 1, begin_.node - 1);
+            destroy_buffer(begin_.node - 1, begin_.node - 1);
         }
     }
 
     // 取出尾部元素
-    template <class T>
-    void deque<T>::pop_back()
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::pop_back()
     {
         MYSTL_DEBUG(!empty());
         if (end_.cur != end_.first) {
@@ -669,10 +870,66 @@ namespace mystl {
         }
     }
 
+    // 删除头部 n 个元素
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::pop_front_n(size_type n)
+    {
+        MYSTL_DEBUG(n <= size());
+        while (n != 0) {
+            const size_type chunk = mystl::min(n, static_cast<size_type>(begin_.last - begin_.cur));
+            mystl::destroy(begin_.cur, begin_.cur + chunk);
+            n -= chunk;
+            if (begin_.cur + chunk == begin_.last) {
+                // 整块删空, 前进到下一个缓冲区并归还这一块
+                map_pointer old = begin_.node;
+                begin_.set_node(old + 1);
+                begin_.cur = begin_.first;
+                destroy_buffer(old, old);
+            }
+            else {
+                begin_.cur += chunk;
+            }
+        }
+    }
+
+    // 删除尾部 n 个元素
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::pop_back_n(size_type n)
+    {
+        MYSTL_DEBUG(n <= size());
+        while (n != 0) {
+            if (end_.cur == end_.first) {
+                // 当前缓冲区已空, 退到上一个缓冲区并归还这一块
+                map_pointer old = end_.node;
+                end_.set_node(old - 1);
+                end_.cur = end_.last;
+                destroy_buffer(old, old);
+            }
+            const size_type chunk = mystl::min(n, static_cast<size_type>(end_.cur - end_.first));
+            end_.cur -= chunk;
+            mystl::destroy(end_.cur, end_.cur + chunk);
+            n -= chunk;
+        }
+    }
+
+    template <class T, size_t BlockBytes>
+    template <class OutputIter>
+    OutputIter deque<T, BlockBytes>::drain_front(size_type n, OutputIter result)
+    {
+        n = mystl::min(n, size());
+        while (n != 0) {
+            const size_type chunk = mystl::min(n, static_cast<size_type>(begin_.last - begin_.cur));
+            result = mystl::move(begin_.cur, begin_.cur + chunk, result);
+            pop_front_n(chunk);
+            n -= chunk;
+        }
+        return result;
+    }
+
     // 在 pos 前插入元素
-    template <class T>
-    typename deque<T>::iterator
-    deque<T>::insert(iterator pos, const value_type &value)
+    template <class T, size_t BlockBytes>
+    typename deque<T, BlockBytes>::iterator
+    deque<T, BlockBytes>::insert(iterator pos, const value_type &value)
     {
         if (pos.cur == begin_.cur) {
             push_front(value);
@@ -689,9 +946,9 @@ namespace mystl {
         }
     }
 
-    template <class T>
-    typename deque<T>::iterator
-    deque<T>::insert(iterator pos, value_type &&value)
+    template <class T, size_t BlockBytes>
+    typename deque<T, BlockBytes>::iterator
+    deque<T, BlockBytes>::insert(iterator pos, value_type &&value)
     {
         if (pos.cur == begin_.cur) {
             emplace_front(mystl::move(value));     // 对于每个 deque, value_type 是确定的,
@@ -710,8 +967,8 @@ namespace mystl {
     }
 
     // 在 pos 前插入 n 个元素
-    template <class T>
-    void deque<T>::insert(iterator pos, size_type n, const value_type &value)
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::insert(iterator pos, size_type n, const value_type &value)
     {
         if (pos.cur == begin_.cur) {
             require_capacity(n, true);
@@ -731,9 +988,9 @@ namespace mystl {
     }
 
     // 删除 pos 处的元素
-    template <class T>
-    typename deque<T>::iterator
-    deque<T>::erase(iterator pos)
+    template <class T, size_t BlockBytes>
+    typename deque<T, BlockBytes>::iterator
+    deque<T, BlockBytes>::erase(iterator pos)
     {
         auto next = pos;
         ++next;
@@ -751,9 +1008,9 @@ namespace mystl {
     }
 
     // 删除 [first, last) 上的元素
-    template <class T>
-    typename deque<T>::iterator
-    deque<T>::erase(iterator first, iterator last)
+    template <class T, size_t BlockBytes>
+    typename deque<T, BlockBytes>::iterator
+    deque<T, BlockBytes>::erase(iterator first, iterator last)
     {
         if (first == begin_ && last == end_) {
             clear();
@@ -779,34 +1036,38 @@ namespace mystl {
     }
 
     // 清空 deque
-    // clear 保留头部缓冲区
+    // clear 保留头部缓冲区, 其余缓冲区归还到空闲缓冲区缓存 (缓存满时才交还分配器)
     /* 问题 ?
-     * MyTinyStl 源代码没有添加(1)处的缓存区释放代码, 应该有内存泄漏问题.
-     * SGI 版本把缓冲区释放了, 但没有将 *cur 置空，为什么? 是因为没必要吗
+     * MyTinyStl 源代码没有释放中间的缓存区, 应该有内存泄漏问题.
+     * SGI 版本把缓冲区释放了, 但没有将 *cur 置空: 之后 shrink_to_fit 会重复释放, 这里一并置空
      */
-    template <class T>
-    void deque<T>::clear()
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::clear()
     {
-        
+        if (map_ == nullptr)
+            return;
         for (map_pointer cur = begin_.node + 1; cur < end_.node; ++cur) {
             mystl::destroy(*cur, *cur + buffer_size);
-            data_allocator::deallocate(*cur, buffer_size);     // (1)
         }
         if (begin_.node != end_.node) {
             mystl::destroy(begin_.cur, begin_.last);
             mystl::destroy(end_.first, end_.cur);
-            data_allocator::deallocate(end_.first, buffer_size);  // 同上
         }
         else {
             mystl::destroy(begin_.cur, end_.cur);
         }
-        shrink_to_fit();   // 清理 begin_ 前和 end_ 后的未使用缓冲区
         end_ = begin_;
+        for (map_pointer cur = map_; cur < map_ + map_size_; ++cur) {
+            if (cur != begin_.node && *cur != nullptr) {
+                deallocate_buffer(*cur);
+                *cur = nullptr;
+            }
+        }
     }
 
     // 交换两个 deque
-    template <class T>
-    void deque<T>::swap(deque &rhs) noexcept
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::swap(deque &rhs) noexcept
     {
         if (this != &rhs) {
             mystl::swap(begin_, rhs.begin_);
@@ -818,9 +1079,9 @@ namespace mystl {
 
     /***************************************************************************************************/
     // helper function
-    template <class T>
-    typename deque<T>::map_pointer
-    deque<T>::create_map(size_type size)
+    template <class T, size_t BlockBytes>
+    typename deque<T, BlockBytes>::map_pointer
+    deque<T, BlockBytes>::create_map(size_type size)
     {
         map_pointer mp = nullptr;
         mp = map_allocator::allocate(size);
@@ -831,36 +1092,85 @@ namespace mystl {
         return mp;
     }
 
-    template <class T>
-    void deque<T>::create_buffer(map_pointer nstart, map_pointer nfinish)
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::create_buffer(map_pointer nstart, map_pointer nfinish)
     {
         map_pointer cur;
         try {
             for (cur = nstart; cur <= nfinish; ++cur) {
-                *cur = data_allocator::allocate(buffer_size);
+                // 槽位上可能留有未使用的缓冲区 (erase 或多申请的), 直接复用, 避免覆盖后泄漏
+                if (*cur == nullptr)
+                    *cur = allocate_buffer();
             }
         }
         catch (...) {
             while (cur != nstart) {
                 --cur;
-                data_allocator::deallocate(*cur, buffer_size);
+                deallocate_buffer(*cur);
                 *cur = nullptr;
             }
             throw;
         }
     }
 
-    template <class T>
-    void deque<T>::destroy_buffer(map_pointer nstart, map_pointer nfinish)
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::destroy_buffer(map_pointer nstart, map_pointer nfinish)
     {
         for (map_pointer n = nstart; n <= nfinish; ++n) {
-            data_allocator::deallocate(*n, buffer_size);
+            deallocate_buffer(*n);
             *n = nullptr;
         }
     }
 
-    template <class T>
-    void deque<T>::map_init(size_type nElem)
+    // 优先从空闲缓冲区缓存中取出一个缓冲区
+    template <class T, size_t BlockBytes>
+    typename deque<T, BlockBytes>::pointer deque<T, BlockBytes>::allocate_buffer()
+    {
+        if (spare_count_ != 0)
+            return spare_[--spare_count_];
+        return data_allocator::allocate(buffer_size);
+    }
+
+    // 缓存未满时放入缓存, 否则交还分配器
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::deallocate_buffer(pointer buf) noexcept
+    {
+        if (buf == nullptr)
+            return;
+        if (spare_count_ < spare_capacity) {
+            spare_[spare_count_++] = buf;
+        }
+        else {
+            data_allocator::deallocate(buf, buffer_size);
+        }
+    }
+
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::release_spare() noexcept
+    {
+        while (spare_count_ != 0)
+            data_allocator::deallocate(spare_[--spare_count_], buffer_size);
+    }
+
+    // 析构所有元素并释放全部缓冲区与 map
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::destroy_storage() noexcept
+    {
+        if (map_ != nullptr) {
+            clear();
+            data_allocator::deallocate(*begin_.node, buffer_size);
+            *begin_.node = nullptr;
+            map_allocator::deallocate(map_, map_size_);
+            map_ = nullptr;
+            map_size_ = 0;
+            begin_ = iterator();
+            end_ = iterator();
+        }
+        release_spare();
+    }
+
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::map_init(size_type nElem)
     {
         const size_type nNode = nElem / buffer_size + 1;             // 需要的缓冲区个数
         map_size_ = mystl::max(static_cast<size_type>(DEQUE_MAP_INIT_SIZE), nNode + 2);
@@ -891,45 +1201,62 @@ namespace mystl {
         end_.cur = end_.first + (nElem % buffer_size);
     }
 
-    template <class T>
-    void deque<T>::fill_init(size_type n, const value_type &value)
+    // 逐块构造, 每构造完一块才推进 end_, 构造抛出异常时释放已申请的全部空间
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::fill_init(size_type n, const value_type &value)
     {
+        if (n == 0)  return;
         map_init(n);
-        if (n != 0) {
-            for (auto cur = begin_.node; cur < end_.node; ++cur) {
-                mystl::uninitialized_fill(*cur, *cur + buffer_size, value);
+        end_ = begin_;
+        try {
+            while (n != 0) {
+                const size_type chunk = mystl::min(n, static_cast<size_type>(end_.last - end_.cur));
+                mystl::uninitialized_fill_n(end_.cur, chunk, value);
+                end_ += chunk;
+                n -= chunk;
             }
-            mystl::uninitialized_fill(end_.first, end_.cur, value);
+        }
+        catch (...) {
+            destroy_storage();
+            throw;
         }
     }
 
-    template <class T>
+    // input iterator 只能遍历一次, 不能先求长度
+    template <class T, size_t BlockBytes>
     template <class IIter>
-    void deque<T>::copy_init(IIter first, IIter last, input_iterator_tag)
+    void deque<T, BlockBytes>::copy_init(IIter first, IIter last, input_iterator_tag)
     {
-        const size_type n = mystl::distance(first, last);
-        map_init(n);
-        for (; first != last; ++first)
-            emplace_back(*first);
+        try {
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+        catch (...) {
+            destroy_storage();
+            throw;
+        }
     }
 
-    template <class T>
+    // map_init 已备好全部缓冲区, append_n 直接复用
+    template <class T, size_t BlockBytes>
     template <class FIter>
-    void deque<T>::copy_init(FIter first, FIter last, forward_iterator_tag)
+    void deque<T, BlockBytes>::copy_init(FIter first, FIter last, forward_iterator_tag)
     {
         const size_type n = mystl::distance(first, last);
+        if (n == 0)  return;
         map_init(n);
-        for (auto cur = begin_.node; cur < end_.node; ++cur) {
-            auto next = first;
-            mystl::advance(next, buffer_size);
-            mystl::uninitialized_copy(first, next, *cur);
-            first = next;
+        end_ = begin_;
+        try {
+            append_n(first, n);
+        }
+        catch (...) {
+            destroy_storage();
+            throw;
         }
-        mystl::uninitialized_copy(first, last, end_.first);
     }
 
-    template <class T>
-    void deque<T>::fill_assign(size_type n, const value_type &value)
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::fill_assign(size_type n, const value_type &value)
     {
         if (n > size()) {
             mystl::fill(begin(), end(), value);
@@ -941,9 +1268,9 @@ namespace mystl {
         }
     }
 
-    template <class T>
+    template <class T, size_t BlockBytes>
     template <class IIter>
-    void deque<T>::copy_assign(IIter first, IIter last, input_iterator_tag)
+    void deque<T, BlockBytes>::copy_assign(IIter first, IIter last, input_iterator_tag)
     {
         auto first1 = begin();
         auto last1  = end();
@@ -958,9 +1285,9 @@ namespace mystl {
         }
     }
 
-    template <class T>
+    template <class T, size_t BlockBytes>
     template <class FIter>
-    void deque<T>::copy_assign(FIter first, FIter last, forward_iterator_tag)
+    void deque<T, BlockBytes>::copy_assign(FIter first, FIter last, forward_iterator_tag)
     {
         const size_type len1 = size();
         const size_type len2 = mystl::distance(first, last);
@@ -975,9 +1302,9 @@ namespace mystl {
         }
     }
 
-    template <class T>
+    template <class T, size_t BlockBytes>
     template <class... Args>
-    typename deque<T>::iterator deque<T>::insert_aux(iterator pos, Args&& ...args)
+    typename deque<T, BlockBytes>::iterator deque<T, BlockBytes>::insert_aux(iterator pos, Args&& ...args)
     {
         const size_type elems_before = pos - begin_;
         value_type value_copy = value_type(mystl::forward<Args>(args)...);
@@ -1007,8 +1334,8 @@ namespace mystl {
         return pos;
     }
 
-    template <class T>
-    void deque<T>::fill_insert(iterator pos, size_type n, const value_type &value)
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::fill_insert(iterator pos, size_type n, const value_type &value)
     {
         const size_type elems_before = pos - begin_;
         const size_type len = size();
@@ -1071,9 +1398,9 @@ namespace mystl {
         }
     }
 
-    template <class T>
+    template <class T, size_t BlockBytes>
     template <class FIter>
-    void deque<T>::copy_insert(iterator pos, FIter first, FIter last, size_type n)
+    void deque<T, BlockBytes>::copy_insert(iterator pos, FIter first, FIter last, size_type n)
     {
         const size_type elems_before = pos - begin_;
         auto len = size();
@@ -1139,9 +1466,9 @@ namespace mystl {
     }
 
     // insert_dispatch 函数
-    template <class T>
+    template <class T, size_t BlockBytes>
     template <class IIter>
-    void deque<T>::
+    void deque<T, BlockBytes>::
     insert_dispatch(iterator position, IIter first, IIter last, input_iterator_tag)
     {
         if (last <= first)  return;
@@ -1160,51 +1487,148 @@ namespace mystl {
         }
     }
 
-    template <class T>
+    template <class T, size_t BlockBytes>
     template <class FIter>
-    void deque<T>::
+    void deque<T, BlockBytes>::
     insert_dispatch(iterator position, FIter first, FIter last, forward_iterator_tag)
     {
-        if (last <= first)  return;
+        if (first == last)  return;
         const size_type n = mystl::distance(first, last);
         if (position.cur == begin_.cur) {
-            require_capacity(n, true);
-            auto new_begin = begin_ - n;
-            try {
-                mystl::uninitialized_copy(first, last, new_begin);
-                begin_ = new_begin;
-            }
-            catch (...)
-            {
-                if(new_begin.node != begin_.node)
-                    destroy_buffer(new_begin.node, begin_.node - 1);
-                throw;
-            }
+            prepend_n(first, n);
         }
         else if (position.cur == end_.cur) {
-            require_capacity(n, false);
-            auto new_end = end_ + n;
-            try {
-                mystl::uninitialized_copy(first, last, end_);
-                end_ = new_end;
-            }
-            catch (...) {
-                if(new_end.node != end_.node)
-                    destroy_buffer(end_.node + 1, new_end.node);
-                throw;
-            }
+            append_n(first, n);
         }
         else {
             copy_insert(position, first, last, n);
         }
     }
 
+    // copy_chunk 函数
+    // 在连续空间 result 上构造 [first, first + n), first 前进 n
+    template <class T, size_t BlockBytes>
+    template <class FIter>
+    void deque<T, BlockBytes>::copy_chunk(FIter &first, size_type n, pointer result)
+    {
+        auto next = first;
+        mystl::advance(next, n);
+        mystl::uninitialized_copy(first, next, result);
+        first = next;
+    }
+
+    // 源为 deque 迭代器时再按源的缓冲区分段, 每段都是连续内存, 可平凡复制的元素逐段 memmove
+    template <class T, size_t BlockBytes>
+    template <class Ref, class Ptr, size_t B>
+    void deque<T, BlockBytes>::copy_chunk(deque_iterator<T, Ref, Ptr, B> &first, size_type n, pointer result)
+    {
+        auto cur = result;
+        try {
+            while (n != 0) {
+                const size_type m = mystl::min(n, static_cast<size_type>(first.last - first.cur));
+                cur = mystl::uninitialized_copy(static_cast<const T*>(first.cur),
+                                                static_cast<const T*>(first.cur + m), cur);
+                first += m;
+                n -= m;
+            }
+        }
+        catch (...) {
+            mystl::destroy(result, cur);
+            throw;
+        }
+    }
+
+    // append_n 函数
+    // 在尾部逐块构造 [first, first + n), 失败时析构已构造的元素, 容器保持原状
+    template <class T, size_t BlockBytes>
+    template <class FIter>
+    void deque<T, BlockBytes>::append_n(FIter first, size_type n)
+    {
+        if (n == 0)  return;
+        require_capacity(n, false);
+        auto cur = end_;
+        try {
+            while (n != 0) {
+                const size_type chunk = mystl::min(n, static_cast<size_type>(cur.last - cur.cur));
+                copy_chunk(first, chunk, cur.cur);
+                cur += chunk;
+                n -= chunk;
+            }
+        }
+        catch (...) {
+            mystl::destroy(end_, cur);
+            throw;
+        }
+        end_ = cur;
+    }
+
+    // prepend_n 函数
+    // 在头部 [begin_ - n, begin_) 逐块构造, 保持 [first, first + n) 的顺序
+    template <class T, size_t BlockBytes>
+    template <class FIter>
+    void deque<T, BlockBytes>::prepend_n(FIter first, size_type n)
+    {
+        if (n == 0)  return;
+        require_capacity(n, true);
+        const auto new_begin = begin_ - n;
+        auto cur = new_begin;
+        try {
+            while (n != 0) {
+                const size_type chunk = mystl::min(n, static_cast<size_type>(cur.last - cur.cur));
+                copy_chunk(first, chunk, cur.cur);
+                cur += chunk;
+                n -= chunk;
+            }
+        }
+        catch (...) {
+            mystl::destroy(new_begin, cur);
+            throw;
+        }
+        begin_ = new_begin;
+    }
+
+    // append_dispatch / prepend_dispatch 函数
+    template <class T, size_t BlockBytes>
+    template <class IIter>
+    void deque<T, BlockBytes>::append_dispatch(IIter first, IIter last, input_iterator_tag)
+    {
+        for (; first != last; ++first)
+            emplace_back(*first);
+    }
+
+    template <class T, size_t BlockBytes>
+    template <class FIter>
+    void deque<T, BlockBytes>::append_dispatch(FIter first, FIter last, forward_iterator_tag)
+    {
+        append_n(first, mystl::distance(first, last));
+    }
+
+    // input iterator 无法预知长度, 先收集到临时 deque 再整体前插
+    template <class T, size_t BlockBytes>
+    template <class IIter>
+    void deque<T, BlockBytes>::prepend_dispatch(IIter first, IIter last, input_iterator_tag)
+    {
+        deque tmp(first, last);
+        prepend_n(mystl::make_move_iterator(tmp.begin()), tmp.size());
+    }
+
+    template <class T, size_t BlockBytes>
+    template <class FIter>
+    void deque<T, BlockBytes>::prepend_dispatch(FIter first, FIter last, forward_iterator_tag)
+    {
+        prepend_n(first, mystl::distance(first, last));
+    }
+
     // require_capacity 函数
-    template <class T>
-    void deque<T>::require_capacity(size_type n, bool front)
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::require_capacity(size_type n, bool front)
     {
+        if (map_ == nullptr) {
+            if (n == 0)  return;
+            map_init(0);
+        }
         if (front && (static_cast<size_type>(begin_.cur - begin_.first) < n)) {
-            const size_type need_buffer = (n - (begin_.cur - begin_.first)) / buffer_size + 1;
+            const size_type need_buffer = (n - (begin_.cur - begin_.first) + buffer_size - 1) / buffer_size;
             if (need_buffer > static_cast<size_type>(begin_.node - map_)) {
                 reallocate_map_at_front(need_buffer);
                 return;
@@ -1212,7 +1636,7 @@ namespace mystl {
             create_buffer(begin_.node - need_buffer, begin_.node - 1);
         }
         else if (!front && (static_cast<size_type>(end_.last - end_.cur - 1) < n)) {
-            const size_type need_buffer = (n - (end_.last - end_.cur - 1)) / buffer_size + 1;
+            const size_type need_buffer = (n - (end_.last - end_.cur - 1) + buffer_size - 1) / buffer_size;
             if (need_buffer > static_cast<size_type>((map_ + map_size_) - end_.node - 1)) {
                 reallocate_map_at_back(need_buffer);
                 return;
@@ -1221,100 +1645,129 @@ namespace mystl {
         }
     }
 
+    // reallocate_map 函数
+    // 为 need_buffer 个新缓冲区腾出 map 空间, 返回 begin_.node 在 map 中的新位置.
+    // 紧挨 [begin_.node, end_.node] 两侧已申请的缓冲区 (reserve 预留的) 随之一起搬移.
+    // map 的大小超过所需节点数的两倍时原地居中 (同 SGI 的 _M_reallocate_map),
+    // 否则才换一块更大的 map, 一直向一端滑动的队列因此不会让 map 无限增长
+    template <class T, size_t BlockBytes>
+    typename deque<T, BlockBytes>::map_pointer
+    deque<T, BlockBytes>::reallocate_map(size_type need_buffer, bool front)
+    {
+        map_pointer lo = begin_.node;
+        map_pointer hi = end_.node + 1;
+        while (lo != map_ && *(lo - 1) != nullptr)
+            --lo;
+        while (hi != map_ + map_size_ && *hi != nullptr)
+            ++hi;
+        // 归还 [lo, hi) 以外的缓冲区, 移动节点后这些槽位会被覆盖
+        for (auto cur = map_; cur < map_ + map_size_; ++cur) {
+            if ((cur < lo || cur >= hi) && *cur != nullptr) {
+                deallocate_buffer(*cur);
+                *cur = nullptr;
+            }
+        }
+
+        const size_type live = end_.node - begin_.node + 1;
+        const size_type owned = hi - lo;
+        size_type front_nodes = begin_.node - lo;
+        size_type back_nodes = hi - end_.node - 1;
+        if (front)
+            front_nodes = mystl::max(front_nodes, need_buffer);
+        else
+            back_nodes = mystl::max(back_nodes, need_buffer);
+        const size_type new_buffer = front_nodes + live + back_nodes;
+
+        map_pointer new_start;  // begin_.node 的新位置
+        if (map_size_ > 2 * new_buffer) {
+            new_start = map_ + (map_size_ - new_buffer) / 2 + front_nodes;
+            map_pointer new_lo = new_start - (begin_.node - lo);
+            if (new_lo < lo)
+                mystl::copy(lo, hi, new_lo);
+            else
+                mystl::copy_backward(lo, hi, new_lo + owned);
+            // 清空节点移走后留下的旧槽位
+            for (auto cur = map_; cur < new_lo; ++cur)
+                *cur = nullptr;
+            for (auto cur = new_lo + owned; cur < map_ + map_size_; ++cur)
+                *cur = nullptr;
+        }
+        else {
+            const size_type new_map_size = mystl::max(map_size_ << 1,
+                                                      map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
+            map_pointer new_map = create_map(new_map_size);
+            new_start = new_map + (new_map_size - new_buffer) / 2 + front_nodes;
+            mystl::copy(lo, hi, new_start - (begin_.node - lo));
+            map_allocator::deallocate(map_, map_size_);
+            map_ = new_map;
+            map_size_ = new_map_size;
+        }
+
+        // 缓冲区本身没有移动, 只需更新节点
+        begin_.set_node(new_start);
+        end_.set_node(new_start + live - 1);
+        return new_start;
+    }
+
     // reallocate_map_at_front 函数
-    template <class T>
-    void deque<T>::reallocate_map_at_front(size_type need_buffer)
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::reallocate_map_at_front(size_type need_buffer)
     {
-        const size_type new_map_size = mystl::max(map_size_ << 1,
-                                                    map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
-        map_pointer new_map = create_map(new_map_size);
-        const size_type old_buffer = end_.node - begin_.node + 1;
-        const size_type new_buffer = old_buffer + need_buffer;
-
-        // 另新的 map 中的指针指向原来的 buffer，并开辟新的 buffer
-        auto begin = new_map + (new_map_size - new_buffer) / 2;
-        auto mid = begin + need_buffer;
-        auto end = mid + old_buffer;
-        create_buffer(begin, mid - 1);
-        for (auto begin1 = mid, begin2 = begin_.node; begin1 != end; ++begin1, ++begin2)
-            *begin1 = *begin2;
-
-        // 更新数据
-        map_allocator::deallocate(map_, map_size_);
-        map_ = new_map;
-        map_size_ = new_map_size;
-        begin_ = iterator(*mid + (begin_.cur - begin_.first), mid);
-        end_ = iterator(*(end - 1) + (end_.cur - end_.first), end - 1);
+        map_pointer start = reallocate_map(need_buffer, true);
+        create_buffer(start - need_buffer, start - 1);
     }
 
     // reallocate_map_at_back 函数
-    template <class T>
-    void deque<T>::reallocate_map_at_back(size_type need_buffer)
+    template <class T, size_t BlockBytes>
+    void deque<T, BlockBytes>::reallocate_map_at_back(size_type need_buffer)
     {
-        const size_type new_map_size = mystl::max(map_size_ << 1,
-                                                    map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
-        map_pointer new_map = create_map(new_map_size);
+        map_pointer start = reallocate_map(need_buffer, false);
         const size_type old_buffer = end_.node - begin_.node + 1;
-        const size_type new_buffer = old_buffer + need_buffer;
-
-        // 另新的 map 中的指针指向原来的 buffer，并开辟新的 buffer
-        auto begin = new_map + ((new_map_size - new_buffer) / 2);
-        auto mid = begin + old_buffer;
-        auto end = mid + need_buffer;
-        for (auto begin1 = begin, begin2 = begin_.node; begin1 != mid; ++begin1, ++begin2)
-            *begin1 = *begin2;
-        create_buffer(mid, end - 1);
-
-        // 更新数据
-        map_allocator::deallocate(map_, map_size_);
-        map_ = new_map;
-        map_size_ = new_map_size;
-        begin_ = iterator(*begin + (begin_.cur - begin_.first), begin);
-        end_ = iterator(*(mid - 1) + (end_.cur - end_.first), mid - 1);
+        create_buffer(start + old_buffer, start + old_buffer + need_buffer - 1);
     }
 
     // 重载比较操作符
-    template <class T>
-    bool operator==(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, size_t BlockBytes>
+    bool operator==(const deque<T, BlockBytes>& lhs, const deque<T, BlockBytes>& rhs)
     {
         return lhs.size() == rhs.size() && 
             mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
     }
 
-    template <class T>
-    bool operator<(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, size_t BlockBytes>
+    bool operator<(const deque<T, BlockBytes>& lhs, const deque<T, BlockBytes>& rhs)
     {
         return mystl::lexicographical_compare(
             lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
     }
 
-    template <class T>
-    bool operator!=(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, size_t BlockBytes>
+    bool operator!=(const deque<T, BlockBytes>& lhs, const deque<T, BlockBytes>& rhs)
     {
         return !(lhs == rhs);
     }
 
-    template <class T>
-    bool operator>(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, size_t BlockBytes>
+    bool operator>(const deque<T, BlockBytes>& lhs, const deque<T, BlockBytes>& rhs)
     {
         return rhs < lhs;
     }
 
-    template <class T>
-    bool operator<=(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, size_t BlockBytes>
+    bool operator<=(const deque<T, BlockBytes>& lhs, const deque<T, BlockBytes>& rhs)
     {
         return !(rhs < lhs);
     }
 
-    template <class T>
-    bool operator>=(const deque<T>& lhs, const deque<T>& rhs)
+    template <class T, size_t BlockBytes>
+    bool operator>=(const deque<T, BlockBytes>& lhs, const deque<T, BlockBytes>& rhs)
     {
         return !(lhs < rhs);
     }
 
     // 重载 mystl 的 swap
-    template <class T>
-    void swap(deque<T>& lhs, deque<T>& rhs)
+    template <class T, size_t BlockBytes>
+    void swap(deque<T, BlockBytes>& lhs, deque<T, BlockBytes>& rhs)
     {
         lhs.swap(rhs);
     }
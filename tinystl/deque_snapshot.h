@@ -0,0 +1,304 @@
+#pragma once
+
+/*
+ * deque 的二进制快照, 元素须是可平凡复制的类型.
+ * save 以 writev 把各缓冲区按分段直接写出, 不逐个序列化元素; load 以 readv 直接读入各缓冲区.
+ * mapped_deque_view 以 mmap 只读映射快照文件, 元素在文件中连续存放, 可随机访问而无需复制.
+ * 文件格式: 64 字节的头部, 之后是全部元素. 仅支持 POSIX 系统
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <type_traits>
+#include <unistd.h>
+
+#include "allocator.h"
+#include "deque.h"
+#include "exceptdef.h"
+#include "util.h"
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+namespace mystl {
+    // 快照头部, 其后紧接元素, 64 字节保证映射后元素的地址对齐
+    struct deque_snapshot_header {
+        char     magic[8];      // "MYSTLDQ"
+        uint32_t version;
+        uint32_t value_size;    // sizeof(T), 读取时校验
+        uint64_t count;         // 元素个数
+        uint64_t data_offset;   // 元素相对文件起点的偏移
+        char     reserved[32];
+    };
+
+    static_assert(sizeof(deque_snapshot_header) == 64, "deque_snapshot_header must be 64 bytes");
+
+    namespace snapshot_detail {
+        const char     magic[8] = {'M', 'Y', 'S', 'T', 'L', 'D', 'Q', '\0'};
+        const uint32_t version = 1;
+
+        inline deque_snapshot_header make_header(uint32_t value_size, uint64_t count) noexcept
+        {
+            deque_snapshot_header h;
+            memset(&h, 0, sizeof(h));
+            memcpy(h.magic, magic, sizeof(magic));
+            h.version = version;
+            h.value_size = value_size;
+            h.count = count;
+            h.data_offset = sizeof(h);
+            return h;
+        }
+
+        inline void check_header(const deque_snapshot_header &h, uint32_t value_size)
+        {
+            THROW_RUNTIME_ERROR_IF(memcmp(h.magic, magic, sizeof(magic)) != 0 || h.version != version,
+                                   "not a deque snapshot");
+            THROW_RUNTIME_ERROR_IF(h.value_size != value_size || h.data_offset < sizeof(h),
+                                   "deque snapshot does not match the element type");
+        }
+
+        // 对 iov[0, n) 做 writev/readv, 处理短读写与 EINTR; 会修改 iov
+        template <class Op>
+        void transfer_all(Op op, int fd, struct iovec *iov, size_t n, const char *what)
+        {
+            while (n > 0) {
+                const int batch = n < static_cast<size_t>(IOV_MAX) ? static_cast<int>(n) : IOV_MAX;
+                const ssize_t r = op(fd, iov, batch);
+                if (r < 0 && errno == EINTR)
+                    continue;
+                THROW_RUNTIME_ERROR_IF(r <= 0, what);
+                size_t left = static_cast<size_t>(r);
+                while (n > 0 && left >= iov->iov_len) {
+                    left -= iov->iov_len;
+                    ++iov;
+                    --n;
+                }
+                if (left > 0) {
+                    iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+                    iov->iov_len -= left;
+                }
+            }
+        }
+    }
+
+    // 把 d 写入 fd 的当前位置
+    template <class T, size_t BlockBytes>
+    void save(const deque<T, BlockBytes> &d, int fd)
+    {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "deque snapshot requires a trivially copyable T");
+        deque_snapshot_header h = snapshot_detail::make_header(sizeof(T), d.size());
+        const size_t cap = d.size() / deque_buf_size<T, BlockBytes>::value + 3;
+        struct iovec *iov = mystl::allocator<struct iovec>::allocate(cap);
+        size_t n = 0;
+        iov[n].iov_base = &h;
+        iov[n].iov_len = sizeof(h);
+        ++n;
+        for (auto s : d.segments()) {
+            if (s.second == 0)
+                continue;
+            iov[n].iov_base = const_cast<void*>(static_cast<const void*>(s.first));
+            iov[n].iov_len = s.second * sizeof(T);
+            ++n;
+        }
+        try {
+            snapshot_detail::transfer_all(::writev, fd, iov, n, "failed to write deque snapshot");
+        }
+        catch (...) {
+            mystl::allocator<struct iovec>::deallocate(iov, cap);
+            throw;
+        }
+        mystl::allocator<struct iovec>::deallocate(iov, cap);
+    }
+
+    // 从 fd 的当前位置读入快照并替换 d 的内容; 失败时 d 不变
+    template <class T, size_t BlockBytes>
+    void load(deque<T, BlockBytes> &d, int fd)
+    {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "deque snapshot requires a trivially copyable T");
+        deque_snapshot_header h;
+        struct iovec hv;
+        hv.iov_base = &h;
+        hv.iov_len = sizeof(h);
+        snapshot_detail::transfer_all(::readv, fd, &hv, 1, "failed to read deque snapshot");
+        snapshot_detail::check_header(h, sizeof(T));
+        if (h.data_offset > sizeof(h)) {
+            THROW_RUNTIME_ERROR_IF(::lseek(fd, static_cast<off_t>(h.data_offset - sizeof(h)), SEEK_CUR) < 0,
+                                   "failed to read deque snapshot");
+        }
+        THROW_LENGTH_ERROR_IF(h.count > static_cast<uint64_t>(d.max_size()), "deque snapshot too long");
+
+        deque<T, BlockBytes> tmp;
+        tmp.resize(static_cast<size_t>(h.count));
+        const size_t cap = tmp.size() / deque_buf_size<T, BlockBytes>::value + 2;
+        struct iovec *iov = mystl::allocator<struct iovec>::allocate(cap);
+        size_t n = 0;
+        for (auto s : tmp.segments()) {
+            if (s.second == 0)
+                continue;
+            iov[n].iov_base = s.first;
+            iov[n].iov_len = s.second * sizeof(T);
+            ++n;
+        }
+        try {
+            snapshot_detail::transfer_all(::readv, fd, iov, n, "failed to read deque snapshot");
+        }
+        catch (...) {
+            mystl::allocator<struct iovec>::deallocate(iov, cap);
+            throw;
+        }
+        mystl::allocator<struct iovec>::deallocate(iov, cap);
+        d.swap(tmp);
+    }
+
+    // 模板类 mapped_deque_view
+    // 只读映射一个 save 写出的快照文件, 迭代器就是 const T*
+    template <class T>
+    class mapped_deque_view {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "mapped_deque_view requires a trivially copyable T");
+
+    public:
+        typedef T                                        value_type;
+        typedef const T*                                 pointer;
+        typedef const T*                                 const_pointer;
+        typedef const T&                                 reference;
+        typedef const T&                                 const_reference;
+        typedef size_t                                   size_type;
+        typedef ptrdiff_t                                difference_type;
+        typedef const T*                                 iterator;
+        typedef const T*                                 const_iterator;
+        typedef mystl::reverse_iterator<const_iterator>  reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+    private:
+        void      *map_;
+        size_type  map_size_;
+        const T   *data_;
+        size_type  size_;
+
+    public:
+        mapped_deque_view() noexcept
+            : map_(nullptr), map_size_(0), data_(nullptr), size_(0)
+        {
+        }
+
+        // 映射 fd 所指文件 offset 处开始的快照, offset 须是页大小的整数倍; 映射建立后 fd 可以关闭
+        explicit mapped_deque_view(int fd, off_t offset = 0)
+            : mapped_deque_view()
+        {
+            map(fd, offset);
+        }
+
+        explicit mapped_deque_view(const char *path)
+            : mapped_deque_view()
+        {
+            const int fd = ::open(path, O_RDONLY);
+            THROW_RUNTIME_ERROR_IF(fd < 0, "failed to open deque snapshot");
+            try {
+                map(fd, 0);
+            }
+            catch (...) {
+                ::close(fd);
+                throw;
+            }
+            ::close(fd);
+        }
+
+        mapped_deque_view(const mapped_deque_view&) = delete;
+        mapped_deque_view& operator=(const mapped_deque_view&) = delete;
+
+        mapped_deque_view(mapped_deque_view &&rhs) noexcept
+            : map_(rhs.map_), map_size_(rhs.map_size_), data_(rhs.data_), size_(rhs.size_)
+        {
+            rhs.map_ = nullptr;
+            rhs.map_size_ = rhs.size_ = 0;
+            rhs.data_ = nullptr;
+        }
+
+        mapped_deque_view& operator=(mapped_deque_view &&rhs) noexcept
+        {
+            if (this != &rhs) {
+                mapped_deque_view tmp(mystl::move(rhs));
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        ~mapped_deque_view()
+        {
+            if (map_ != nullptr)
+                ::munmap(map_, map_size_);
+        }
+
+    public:
+        // 迭代器相关操作
+        const_iterator         begin()   const noexcept { return data_; }
+        const_iterator         end()     const noexcept { return data_ + size_; }
+        const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+        // 容量相关操作
+        bool            empty() const noexcept { return size_ == 0; }
+        size_type       size()  const noexcept { return size_; }
+
+        // 访问元素相关操作
+        const_reference operator[](size_type n) const
+        {
+            MYSTL_DEBUG(n < size_);
+            return data_[n];
+        }
+        const_reference at(size_type n) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size_), "mapped_deque_view<T>::at() subscript out of range");
+            return data_[n];
+        }
+        const_reference front() const { MYSTL_DEBUG(!empty()); return data_[0]; }
+        const_reference back()  const { MYSTL_DEBUG(!empty()); return data_[size_ - 1]; }
+        const_pointer   data()  const noexcept { return data_; }
+
+        void swap(mapped_deque_view &rhs) noexcept
+        {
+            mystl::swap(map_, rhs.map_);
+            mystl::swap(map_size_, rhs.map_size_);
+            mystl::swap(data_, rhs.data_);
+            mystl::swap(size_, rhs.size_);
+        }
+
+    private:
+        void map(int fd, off_t offset)
+        {
+            struct stat st;
+            THROW_RUNTIME_ERROR_IF(::fstat(fd, &st) != 0, "failed to stat deque snapshot");
+            THROW_RUNTIME_ERROR_IF(st.st_size < offset + static_cast<off_t>(sizeof(deque_snapshot_header)),
+                                   "not a deque snapshot");
+            const size_type len = static_cast<size_type>(st.st_size - offset);
+            void *p = ::mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, offset);
+            THROW_RUNTIME_ERROR_IF(p == MAP_FAILED, "failed to map deque snapshot");
+            try {
+                const deque_snapshot_header *h = static_cast<const deque_snapshot_header*>(p);
+                snapshot_detail::check_header(*h, sizeof(T));
+                THROW_RUNTIME_ERROR_IF(h->data_offset % alignof(T) != 0 ||
+                                       h->data_offset > len ||
+                                       h->count > (len - h->data_offset) / sizeof(T),
+                                       "deque snapshot is truncated");
+                data_ = reinterpret_cast<const T*>(static_cast<const char*>(p) + h->data_offset);
+                size_ = static_cast<size_type>(h->count);
+            }
+            catch (...) {
+                ::munmap(p, len);
+                throw;
+            }
+            map_ = p;
+            map_size_ = len;
+        }
+    };
+};
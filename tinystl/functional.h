@@ -0,0 +1,37 @@
+#pragma once
+
+/*
+ * 函数对象: less / greater / equal_to
+ */
+
+namespace mystl {
+    // 函数对象: 小于
+    template <class T>
+    struct less {
+        typedef T     first_argument_type;
+        typedef T     second_argument_type;
+        typedef bool  result_type;
+
+        bool operator()(const T &x, const T &y) const { return x < y; }
+    };
+
+    // 函数对象: 大于
+    template <class T>
+    struct greater {
+        typedef T     first_argument_type;
+        typedef T     second_argument_type;
+        typedef bool  result_type;
+
+        bool operator()(const T &x, const T &y) const { return x > y; }
+    };
+
+    // 函数对象: 等于
+    template <class T>
+    struct equal_to {
+        typedef T     first_argument_type;
+        typedef T     second_argument_type;
+        typedef bool  result_type;
+
+        bool operator()(const T &x, const T &y) const { return x == y; }
+    };
+};
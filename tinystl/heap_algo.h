@@ -0,0 +1,204 @@
+#pragma once
+
+/*
+ * heap 算法: push_heap / pop_heap / make_heap / sort_heap
+ * 内部实现以堆的分叉数 Arity 为模板参数, 标准接口为二叉堆,
+ * dary_* 系列接口提供 d 叉堆 (d 越大树越矮, 下沉时一次比较的孩子在同一缓存行中)
+ */
+
+#include "functional.h"
+#include "iterator.h"
+#include "util.h"
+
+namespace mystl {
+    /*****************************************************************************************/
+    // push_heap
+    // 该函数接受两个迭代器, 表示一个 heap 容器的首尾, 并且新元素已经插入到底部容器的最尾端, 调整 heap
+    /*****************************************************************************************/
+    template <size_t Arity, class RandomIter, class Distance, class T, class Compare>
+    void __push_heap_aux(RandomIter first, Distance hole_index, Distance top_index,
+                         T value, Compare comp)
+    {
+        auto parent = (hole_index - 1) / static_cast<Distance>(Arity);
+        // 上溯: 父节点不如新值时, 父节点下移
+        while (hole_index > top_index && comp(*(first + parent), value)) {
+            *(first + hole_index) = mystl::move(*(first + parent));
+            hole_index = parent;
+            parent = (hole_index - 1) / static_cast<Distance>(Arity);
+        }
+        *(first + hole_index) = mystl::move(value);
+    }
+
+    template <size_t Arity, class RandomIter, class Compare>
+    void __push_heap(RandomIter first, RandomIter last, Compare comp)
+    {
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        const Distance len = last - first;
+        if (len > 1) {
+            auto value = mystl::move(*(last - 1));
+            mystl::__push_heap_aux<Arity>(first, len - 1, static_cast<Distance>(0),
+                                          mystl::move(value), comp);
+        }
+    }
+
+    template <class RandomIter>
+    void push_heap(RandomIter first, RandomIter last)
+    {
+        mystl::__push_heap<2>(first, last,
+                              mystl::less<typename iterator_traits<RandomIter>::value_type>());
+    }
+
+    // 重载版本使用函数对象 comp 代替比较操作
+    template <class RandomIter, class Compare>
+    void push_heap(RandomIter first, RandomIter last, Compare comp)
+    {
+        mystl::__push_heap<2>(first, last, comp);
+    }
+
+    /*****************************************************************************************/
+    // pop_heap
+    // 该函数接受两个迭代器, 表示 heap 容器的首尾, 将 heap 的根节点取出放到容器尾部, 调整 heap
+    /*****************************************************************************************/
+    // 从 hole_index 开始下沉到叶子, 再把 value 上溯回合适的位置
+    template <size_t Arity, class RandomIter, class Distance, class T, class Compare>
+    void __adjust_heap(RandomIter first, Distance hole_index, Distance len, T value, Compare comp)
+    {
+        const auto top_index = hole_index;
+        const auto d = static_cast<Distance>(Arity);
+        auto child = hole_index * d + 1;
+        while (child < len) {
+            // 在至多 Arity 个孩子中选出最大的一个
+            auto best = child;
+            const auto child_end = len - child < d ? len : child + d;
+            for (auto i = child + 1; i < child_end; ++i) {
+                if (comp(*(first + best), *(first + i)))
+                    best = i;
+            }
+            *(first + hole_index) = mystl::move(*(first + best));
+            hole_index = best;
+            child = hole_index * d + 1;
+        }
+        mystl::__push_heap_aux<Arity>(first, hole_index, top_index, mystl::move(value), comp);
+    }
+
+    template <size_t Arity, class RandomIter, class Compare>
+    void __pop_heap(RandomIter first, RandomIter last, Compare comp)
+    {
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        if (last - first < 2)
+            return;
+        --last;
+        auto value = mystl::move(*last);
+        *last = mystl::move(*first);
+        mystl::__adjust_heap<Arity>(first, static_cast<Distance>(0), last - first,
+                                    mystl::move(value), comp);
+    }
+
+    template <class RandomIter>
+    void pop_heap(RandomIter first, RandomIter last)
+    {
+        mystl::__pop_heap<2>(first, last,
+                             mystl::less<typename iterator_traits<RandomIter>::value_type>());
+    }
+
+    // 重载版本使用函数对象 comp 代替比较操作
+    template <class RandomIter, class Compare>
+    void pop_heap(RandomIter first, RandomIter last, Compare comp)
+    {
+        mystl::__pop_heap<2>(first, last, comp);
+    }
+
+    /*****************************************************************************************/
+    // sort_heap
+    // 该函数接受两个迭代器, 表示 heap 容器的首尾, 不断执行 pop_heap 操作, 直到首尾最多相差1
+    /*****************************************************************************************/
+    template <size_t Arity, class RandomIter, class Compare>
+    void __sort_heap(RandomIter first, RandomIter last, Compare comp)
+    {
+        // 每执行一次 pop_heap, 最大的元素都被放到尾部, 直到容器最多只有一个元素, 完成排序
+        while (last - first > 1)
+            mystl::__pop_heap<Arity>(first, last--, comp);
+    }
+
+    template <class RandomIter>
+    void sort_heap(RandomIter first, RandomIter last)
+    {
+        mystl::__sort_heap<2>(first, last,
+                              mystl::less<typename iterator_traits<RandomIter>::value_type>());
+    }
+
+    // 重载版本使用函数对象 comp 代替比较操作
+    template <class RandomIter, class Compare>
+    void sort_heap(RandomIter first, RandomIter last, Compare comp)
+    {
+        mystl::__sort_heap<2>(first, last, comp);
+    }
+
+    /*****************************************************************************************/
+    // make_heap
+    // 该函数接受两个迭代器, 表示 heap 容器的首尾, 把容器内的数据变为一个 heap, 时间复杂度 O(n)
+    /*****************************************************************************************/
+    template <size_t Arity, class RandomIter, class Compare>
+    void __make_heap(RandomIter first, RandomIter last, Compare comp)
+    {
+        typedef typename iterator_traits<RandomIter>::difference_type Distance;
+        const Distance len = last - first;
+        if (len < 2)
+            return;
+        // 从最后一个非叶子节点开始, 自底向上逐个下沉
+        auto hole_index = (len - 2) / static_cast<Distance>(Arity);
+        while (true) {
+            auto value = mystl::move(*(first + hole_index));
+            mystl::__adjust_heap<Arity>(first, hole_index, len, mystl::move(value), comp);
+            if (hole_index == 0)
+                return;
+            --hole_index;
+        }
+    }
+
+    template <class RandomIter>
+    void make_heap(RandomIter first, RandomIter last)
+    {
+        mystl::__make_heap<2>(first, last,
+                              mystl::less<typename iterator_traits<RandomIter>::value_type>());
+    }
+
+    // 重载版本使用函数对象 comp 代替比较操作
+    template <class RandomIter, class Compare>
+    void make_heap(RandomIter first, RandomIter last, Compare comp)
+    {
+        mystl::__make_heap<2>(first, last, comp);
+    }
+
+    /*****************************************************************************************/
+    // dary_push_heap / dary_pop_heap / dary_make_heap / dary_sort_heap
+    // 以 Arity 叉堆组织 [first, last), 语义与对应的二叉堆版本相同
+    /*****************************************************************************************/
+    template <size_t Arity, class RandomIter, class Compare>
+    void dary_push_heap(RandomIter first, RandomIter last, Compare comp)
+    {
+        static_assert(Arity >= 2, "heap arity must be at least 2");
+        mystl::__push_heap<Arity>(first, last, comp);
+    }
+
+    template <size_t Arity, class RandomIter, class Compare>
+    void dary_pop_heap(RandomIter first, RandomIter last, Compare comp)
+    {
+        static_assert(Arity >= 2, "heap arity must be at least 2");
+        mystl::__pop_heap<Arity>(first, last, comp);
+    }
+
+    template <size_t Arity, class RandomIter, class Compare>
+    void dary_make_heap(RandomIter first, RandomIter last, Compare comp)
+    {
+        static_assert(Arity >= 2, "heap arity must be at least 2");
+        mystl::__make_heap<Arity>(first, last, comp);
+    }
+
+    template <size_t Arity, class RandomIter, class Compare>
+    void dary_sort_heap(RandomIter first, RandomIter last, Compare comp)
+    {
+        static_assert(Arity >= 2, "heap arity must be at least 2");
+        mystl::__sort_heap<Arity>(first, last, comp);
+    }
+};
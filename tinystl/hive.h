@@ -0,0 +1,549 @@
+#pragma once
+
+/*
+ * 模板类 hive
+ * 元素地址稳定的无序容器: 元素存放在定长的块中, 插入与删除都不移动其它元素.
+ * 每块带一个跳跃计数 (jump-counting) 跳表: 连续被删除的槽位构成一段, 段首与段尾记录段长,
+ * 其余槽位记 0, 遍历时一次跳过整段空位. 被删除的段以块内双向链表串起来 (链表节点就存放在段首槽位中),
+ * 插入时优先复用; 有空位的块再串成一个链表. 块中元素全部删除后立即释放该块
+ */
+
+#include <initializer_list>
+#include <stdint.h>
+#include <type_traits>
+
+#include "allocator.h"
+#include "construct.h"
+#include "deque.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "util.h"
+
+namespace mystl {
+    // hive 的块
+    template <class T>
+    struct hive_group {
+        typedef uint16_t   skip_type;
+        typedef size_t     size_type;
+
+        // 空位段的链表节点, 存放在段首槽位中
+        struct free_node {
+            skip_type prev;
+            skip_type next;
+        };
+
+        typedef typename std::aligned_storage<
+            (sizeof(T) > sizeof(free_node) ? sizeof(T) : sizeof(free_node)),
+            (alignof(T) > alignof(free_node) ? alignof(T) : alignof(free_node))>::type slot_type;
+
+        static const skip_type none = 0xFFFF;  // 空链表
+
+        slot_type  *slots;      // 元素槽位
+        skip_type  *skip;       // 跳表, 共 capacity + 1 项, skip[capacity] 恒为 0
+        hive_group *prev;       // 前一块
+        hive_group *next;       // 后一块
+        hive_group *prev_free;  // 有空位的块构成的链表
+        hive_group *next_free;
+        size_type   size;       // 块中的元素个数
+        skip_type   capacity;   // 块中的槽位个数
+        skip_type   free_head;  // 第一个空位段的段首
+
+        T*         element(size_type i) noexcept { return reinterpret_cast<T*>(slots + i); }
+        free_node* node(size_type i)    noexcept { return reinterpret_cast<free_node*>(slots + i); }
+    };
+
+    // hive 的迭代器: (块, 槽位下标), 双向迭代, 自动跳过空位
+    template <class T, class Ref, class Ptr>
+    struct hive_iterator : public iterator<bidirectional_iterator_tag, T> {
+        typedef hive_iterator<T, T&, T*>              iterator;
+        typedef hive_iterator<T, const T&, const T*>  const_iterator;
+        typedef hive_iterator                         self;
+
+        typedef T             value_type;
+        typedef Ptr           pointer;
+        typedef Ref           reference;
+        typedef size_t        size_type;
+        typedef ptrdiff_t     difference_type;
+        typedef hive_group<T> group;
+
+        group     *g;      // 所在块, 空 hive 的迭代器为空
+        size_type  index;  // 槽位下标, 尾后迭代器为 (最后一块, capacity)
+
+        hive_iterator() noexcept : g(nullptr), index(0) {}
+        hive_iterator(group *x, size_type i) noexcept : g(x), index(i) {}
+        hive_iterator(const iterator &rhs) noexcept : g(rhs.g), index(rhs.index) {}
+
+        self& operator=(const iterator &rhs) noexcept
+        {
+            g = rhs.g;
+            index = rhs.index;
+            return *this;
+        }
+
+        reference operator*()  const { return *g->element(index); }
+        pointer   operator->() const { return &(operator*()); }
+
+        self& operator++()
+        {
+            ++index;
+            index += g->skip[index];
+            if (index == g->capacity && g->next != nullptr) {
+                g = g->next;
+                index = g->skip[0];
+            }
+            return *this;
+        }
+        self operator++(int)
+        {
+            self tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        self& operator--()
+        {
+            for (;;) {
+                if (index == 0) {
+                    g = g->prev;
+                    index = g->capacity;
+                }
+                --index;
+                if (g->skip[index] == 0)
+                    return *this;
+                // 落在空位段的段尾, 跳到段首之前
+                index = index + 1 - g->skip[index];
+            }
+        }
+        self operator--(int)
+        {
+            self tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        bool operator==(const self &rhs) const { return g == rhs.g && index == rhs.index; }
+        bool operator!=(const self &rhs) const { return !(*this == rhs); }
+    };
+
+    // 模板类 hive
+    template <class T>
+    class hive {
+    public:
+        typedef T                                        value_type;
+        typedef T*                                       pointer;
+        typedef const T*                                 const_pointer;
+        typedef T&                                       reference;
+        typedef const T&                                 const_reference;
+        typedef size_t                                   size_type;
+        typedef ptrdiff_t                                difference_type;
+
+        typedef hive_iterator<T, T&, T*>                 iterator;
+        typedef hive_iterator<T, const T&, const T*>     const_iterator;
+        typedef mystl::reverse_iterator<iterator>        reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+    private:
+        typedef hive_group<T>                            group;
+        typedef typename group::skip_type                skip_type;
+        typedef typename group::slot_type                slot_type;
+        typedef typename group::free_node                free_node;
+
+        typedef mystl::allocator<group>                  group_allocator;
+        typedef mystl::allocator<slot_type>              slot_allocator;
+        typedef mystl::allocator<skip_type>              skip_allocator;
+
+    public:
+        // 每块的槽位个数: 与 deque 的缓冲区大小相同, 且不超过跳表能表示的范围
+        static const size_type group_capacity =
+            deque_buf_size<slot_type>::value < 0xFFFF ? deque_buf_size<slot_type>::value : 0xFFFF;
+
+    private:
+        group     *first_;        // 第一块
+        group     *last_;         // 最后一块
+        group     *free_groups_;  // 有空位的块
+        size_type  size_;
+
+    public:
+        // 构造、复制、移动、析构函数
+        hive() noexcept
+            : first_(nullptr), last_(nullptr), free_groups_(nullptr), size_(0)
+        {
+        }
+
+        template <class IIter, typename std::enable_if<
+            mystl::is_input_iterator<IIter>::value, int>::type = 0>
+        hive(IIter first, IIter last)
+            : hive()
+        {
+            for (; first != last; ++first)
+                emplace(*first);
+        }
+
+        hive(std::initializer_list<value_type> ilist)
+            : hive(ilist.begin(), ilist.end())
+        {
+        }
+
+        hive(const hive &rhs)
+            : hive(rhs.begin(), rhs.end())
+        {
+        }
+
+        hive(hive &&rhs) noexcept
+            : first_(rhs.first_), last_(rhs.last_), free_groups_(rhs.free_groups_), size_(rhs.size_)
+        {
+            rhs.first_ = rhs.last_ = rhs.free_groups_ = nullptr;
+            rhs.size_ = 0;
+        }
+
+        hive& operator=(const hive &rhs)
+        {
+            if (this != &rhs) {
+                hive tmp(rhs);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        hive& operator=(hive &&rhs) noexcept
+        {
+            if (this != &rhs) {
+                hive tmp(mystl::move(rhs));
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        ~hive()
+        {
+            clear();
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator               begin()         noexcept
+        { return first_ == nullptr ? iterator() : iterator(first_, first_->skip[0]); }
+        const_iterator         begin()   const noexcept
+        { return first_ == nullptr ? const_iterator() : const_iterator(first_, first_->skip[0]); }
+        iterator               end()           noexcept
+        { return last_ == nullptr ? iterator() : iterator(last_, last_->capacity); }
+        const_iterator         end()     const noexcept
+        { return last_ == nullptr ? const_iterator() : const_iterator(last_, last_->capacity); }
+
+        reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator         cbegin()  const noexcept { return begin(); }
+        const_iterator         cend()    const noexcept { return end(); }
+
+        // 容量相关操作
+        bool      empty()    const noexcept { return size_ == 0; }
+        size_type size()     const noexcept { return size_; }
+        size_type capacity() const noexcept
+        {
+            size_type n = 0;
+            for (group *g = first_; g != nullptr; g = g->next)
+                n += g->capacity;
+            return n;
+        }
+
+        // 修改容器相关操作
+        // 插入后其它元素的地址与迭代器均不失效
+        template <class ...Args>
+        iterator    emplace(Args&& ...args);
+
+        iterator    insert(const value_type &value) { return emplace(value); }
+        iterator    insert(value_type &&value)      { return emplace(mystl::move(value)); }
+
+        // 删除后只有被删除元素的迭代器失效 (所在块被释放时, 该块的尾后迭代器也失效)
+        iterator    erase(const_iterator pos);
+        iterator    erase(const_iterator first, const_iterator last);
+        void        clear();
+
+        // 由元素地址得到迭代器, 复杂度与块数成正比
+        iterator    get_iterator(const_pointer p) noexcept;
+
+        void        swap(hive &rhs) noexcept
+        {
+            mystl::swap(first_, rhs.first_);
+            mystl::swap(last_, rhs.last_);
+            mystl::swap(free_groups_, rhs.free_groups_);
+            mystl::swap(size_, rhs.size_);
+        }
+
+    private:
+        // helper functions
+        group*      create_group();
+        void        destroy_group(group *g) noexcept;
+
+        // 有空位的块构成的链表
+        void        link_free(group *g) noexcept;
+        void        unlink_free(group *g) noexcept;
+
+        // 块内的空位段链表
+        void        push_run(group *g, skip_type start) noexcept;
+        void        unlink_run(group *g, skip_type start) noexcept;
+        void        move_run(group *g, skip_type from, skip_type to) noexcept;
+    };
+
+    /*****************************************************************************************/
+
+    // 在第一个有空位的块的第一个空位段段首构造元素
+    template <class T>
+    template <class ...Args>
+    typename hive<T>::iterator hive<T>::emplace(Args&& ...args)
+    {
+        if (free_groups_ == nullptr)
+            create_group();
+        group *g = free_groups_;
+        const skip_type s = g->free_head;
+        const skip_type len = g->skip[s];
+        const free_node n = *g->node(s);
+        try {
+            mystl::construct(g->element(s), mystl::forward<Args>(args)...);
+        }
+        catch (...) {
+            *g->node(s) = n;
+            if (g->size == 0)
+                destroy_group(g);
+            throw;
+        }
+
+        g->skip[s] = 0;
+        if (len == 1) {
+            // 整段用完, 从链表中摘除
+            g->free_head = n.next;
+            if (n.next != group::none)
+                g->node(n.next)->prev = group::none;
+            else
+                unlink_free(g);
+        }
+        else {
+            // 段首后移一位
+            const skip_type ns = s + 1;
+            g->skip[ns] = g->skip[s + len - 1] = len - 1;
+            g->node(ns)->prev = group::none;
+            g->node(ns)->next = n.next;
+            if (n.next != group::none)
+                g->node(n.next)->prev = ns;
+            g->free_head = ns;
+        }
+        ++g->size;
+        ++size_;
+        return iterator(g, s);
+    }
+
+    // 删除 pos 处的元素, 与相邻的空位段合并
+    template <class T>
+    typename hive<T>::iterator hive<T>::erase(const_iterator pos)
+    {
+        MYSTL_DEBUG(pos != end());
+        group *g = pos.g;
+        const skip_type i = static_cast<skip_type>(pos.index);
+        mystl::destroy(g->element(i));
+        --size_;
+
+        if (--g->size == 0) {
+            // 整块已空, 释放该块
+            group *next = g->next;
+            destroy_group(g);
+            return next != nullptr ? iterator(next, next->skip[0]) : end();
+        }
+
+        const skip_type left = i != 0 ? g->skip[i - 1] : 0;   // 左侧空位段的长度
+        const skip_type right = g->skip[i + 1];                // 右侧空位段的长度
+        if (left == 0 && right == 0) {
+            g->skip[i] = 1;
+            if (g->free_head == group::none)
+                link_free(g);
+            push_run(g, i);
+        }
+        else if (right == 0) {
+            const skip_type start = i - left;
+            g->skip[start] = g->skip[i] = left + 1;
+        }
+        else if (left == 0) {
+            g->skip[i] = g->skip[i + right] = right + 1;
+            move_run(g, i + 1, i);
+        }
+        else {
+            const skip_type start = i - left;
+            g->skip[start] = g->skip[i + right] = left + 1 + right;
+            unlink_run(g, i + 1);
+        }
+
+        // 从合并后空位段的段尾向后找下一个元素
+        iterator next(g, static_cast<size_type>(i) + right);
+        return ++next;
+    }
+
+    template <class T>
+    typename hive<T>::iterator hive<T>::erase(const_iterator first, const_iterator last)
+    {
+        iterator it(first.g, first.index);
+        // last 所在的块可能被释放, 先记下待删除的个数
+        size_type n = 0;
+        for (auto cur = first; cur != last; ++cur)
+            ++n;
+        for (; n > 0; --n)
+            it = erase(it);
+        return it;
+    }
+
+    template <class T>
+    void hive<T>::clear()
+    {
+        while (first_ != nullptr) {
+            group *g = first_;
+            if (g->size != 0) {
+                for (size_type i = g->skip[0]; i < g->capacity; ) {
+                    mystl::destroy(g->element(i));
+                    ++i;
+                    i += g->skip[i];
+                }
+            }
+            size_ -= g->size;
+            destroy_group(g);
+        }
+    }
+
+    template <class T>
+    typename hive<T>::iterator hive<T>::get_iterator(const_pointer p) noexcept
+    {
+        for (group *g = first_; g != nullptr; g = g->next) {
+            const slot_type *s = reinterpret_cast<const slot_type*>(p);
+            if (s >= g->slots && s < g->slots + g->capacity)
+                return iterator(g, static_cast<size_type>(s - g->slots));
+        }
+        return end();
+    }
+
+    /*****************************************************************************************/
+    // helper function
+
+    // 新块整体作为一个空位段, 接在最后一块之后
+    template <class T>
+    typename hive<T>::group* hive<T>::create_group()
+    {
+        const skip_type cap = static_cast<skip_type>(group_capacity);
+        group *g = group_allocator::allocate(1);
+        try {
+            g->slots = slot_allocator::allocate(cap);
+            try {
+                g->skip = skip_allocator::allocate(static_cast<size_type>(cap) + 1);
+            }
+            catch (...) {
+                slot_allocator::deallocate(g->slots, cap);
+                throw;
+            }
+        }
+        catch (...) {
+            group_allocator::deallocate(g, 1);
+            throw;
+        }
+        g->capacity = cap;
+        g->size = 0;
+        g->skip[0] = g->skip[cap - 1] = cap;
+        g->skip[cap] = 0;
+        g->free_head = 0;
+        g->node(0)->prev = g->node(0)->next = group::none;
+
+        g->prev = last_;
+        g->next = nullptr;
+        if (last_ != nullptr)
+            last_->next = g;
+        else
+            first_ = g;
+        last_ = g;
+        g->prev_free = g->next_free = nullptr;
+        link_free(g);
+        return g;
+    }
+
+    // 从两个链表中摘除并释放, 块中不应再有元素
+    template <class T>
+    void hive<T>::destroy_group(group *g) noexcept
+    {
+        if (g->free_head != group::none)
+            unlink_free(g);
+        if (g->prev != nullptr)
+            g->prev->next = g->next;
+        else
+            first_ = g->next;
+        if (g->next != nullptr)
+            g->next->prev = g->prev;
+        else
+            last_ = g->prev;
+        skip_allocator::deallocate(g->skip, static_cast<size_type>(g->capacity) + 1);
+        slot_allocator::deallocate(g->slots, g->capacity);
+        group_allocator::deallocate(g, 1);
+    }
+
+    template <class T>
+    void hive<T>::link_free(group *g) noexcept
+    {
+        g->prev_free = nullptr;
+        g->next_free = free_groups_;
+        if (free_groups_ != nullptr)
+            free_groups_->prev_free = g;
+        free_groups_ = g;
+    }
+
+    template <class T>
+    void hive<T>::unlink_free(group *g) noexcept
+    {
+        if (g->prev_free != nullptr)
+            g->prev_free->next_free = g->next_free;
+        else
+            free_groups_ = g->next_free;
+        if (g->next_free != nullptr)
+            g->next_free->prev_free = g->prev_free;
+        g->prev_free = g->next_free = nullptr;
+    }
+
+    template <class T>
+    void hive<T>::push_run(group *g, skip_type start) noexcept
+    {
+        free_node *n = g->node(start);
+        n->prev = group::none;
+        n->next = g->free_head;
+        if (g->free_head != group::none)
+            g->node(g->free_head)->prev = start;
+        g->free_head = start;
+    }
+
+    template <class T>
+    void hive<T>::unlink_run(group *g, skip_type start) noexcept
+    {
+        const free_node n = *g->node(start);
+        if (n.prev != group::none)
+            g->node(n.prev)->next = n.next;
+        else
+            g->free_head = n.next;
+        if (n.next != group::none)
+            g->node(n.next)->prev = n.prev;
+    }
+
+    // 空位段的段首由 from 变为 to, 链表节点随之搬移
+    template <class T>
+    void hive<T>::move_run(group *g, skip_type from, skip_type to) noexcept
+    {
+        const free_node n = *g->node(from);
+        *g->node(to) = n;
+        if (n.prev != group::none)
+            g->node(n.prev)->next = to;
+        else
+            g->free_head = to;
+        if (n.next != group::none)
+            g->node(n.next)->prev = to;
+    }
+
+    // 重载 mystl 的 swap
+    template <class T>
+    void swap(hive<T> &lhs, hive<T> &rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+};
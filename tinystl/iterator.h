@@ -11,6 +11,10 @@ namespace mystl {
     struct bidirectional_iterator_tag : public forward_iterator_tag {};
     struct random_access_iterator_tag : public bidirectional_iterator_tag {};
 
+    // 连续迭代器: 元素在内存中连续存放, 可以换算为原生指针做整块的内存操作
+    // 原生指针属于此类, 自定义迭代器只需将 iterator_category 定义为该型别并提供 operator->
+    struct contiguous_iterator_tag : public random_access_iterator_tag {};
+
     // iterator 模板
     template <class Category, class T, class Distance = ptrdiff_t, class Pointer = T*,
               class Reference = T&>
@@ -70,7 +74,7 @@ namespace mystl {
     // 针对原生指针的偏特化版本
     template <class T>
     struct iterator_traits<T *> {
-        typedef random_access_iterator_tag                 iterator_category;
+        typedef contiguous_iterator_tag                    iterator_category;
         typedef T                                          value_type;
         typedef T*                                         pointer;
         typedef T&                                         reference;
@@ -79,7 +83,7 @@ namespace mystl {
 
     template <class T>
     struct iterator_traits<const T *> {
-        typedef random_access_iterator_tag                 iterator_category;
+        typedef contiguous_iterator_tag                    iterator_category;
         typedef T                                          value_type;
         typedef const T*                                   pointer;
         typedef const T&                                   reference;
@@ -112,6 +116,9 @@ namespace mystl {
     template <class Iter>
     struct is_random_access_iterator : public has_iterator_of<Iter, random_access_iterator_tag> {};
 
+    template <class Iter>
+    struct is_contiguous_iterator : public has_iterator_of<Iter, contiguous_iterator_tag> {};
+
     template <class Iterator>
     struct is_iterator :
         public bool_constant<is_input_iterator<Iterator>::value ||
@@ -119,6 +126,22 @@ namespace mystl {
 
     };
 
+    /*
+     * to_address
+     * 取得连续迭代器所指元素的原生指针, 对于自定义迭代器通过 operator-> 获得
+     */
+    template <class T>
+    constexpr T* to_address(T *p) noexcept
+    {
+        return p;
+    }
+
+    template <class Iterator>
+    auto to_address(const Iterator &i) noexcept -> decltype(mystl::to_address(i.operator->()))
+    {
+        return mystl::to_address(i.operator->());
+    }
+
     // 萃取迭代器的 category
     template <class Iterator>
     typename iterator_traits<Iterator>::iterator_category iterator_category(const Iterator &)
@@ -217,7 +240,10 @@ namespace mystl {
         Iterator current;
     
     public:
-        typedef typename iterator_traits<Iterator>::iterator_category iterator_category;
+        // 反向之后元素不再按地址递增, 连续迭代器退化为随机迭代器
+        typedef typename std::conditional<
+            is_contiguous_iterator<Iterator>::value, random_access_iterator_tag,
+            typename iterator_traits<Iterator>::iterator_category>::type iterator_category;
         typedef typename iterator_traits<Iterator>::value_type        value_type;
         typedef typename iterator_traits<Iterator>::difference_type   difference_type;
         typedef typename iterator_traits<Iterator>::pointer           pointer;
@@ -231,6 +257,12 @@ namespace mystl {
         explicit reverse_iterator(Iterator_type i) : current(i) {}
         reverse_iterator(const self &rhs) : current(rhs.current) {}
 
+        self& operator=(const self &rhs)
+        {
+            current = rhs.current;
+            return *this;
+        }
+
     public:
         Iterator_type base() const
         {
@@ -350,4 +382,236 @@ namespace mystl {
     {
         return !(lhs < rhs);
     }
+
+    /*********************************************************************************************/
+    /*
+     * 模板类: move_iterator
+     * 移动迭代器, 解引用得到右值引用, 配合 copy / uninitialized_copy / insert 可以批量移动元素
+     */
+    template <class Iterator>
+    class move_iterator {
+    private:
+        Iterator current;
+
+    public:
+        // 解引用得到的是临时的右值, 不再满足连续迭代器的要求
+        typedef typename std::conditional<
+            is_contiguous_iterator<Iterator>::value, random_access_iterator_tag,
+            typename iterator_traits<Iterator>::iterator_category>::type iterator_category;
+        typedef typename iterator_traits<Iterator>::value_type        value_type;
+        typedef typename iterator_traits<Iterator>::difference_type   difference_type;
+        typedef Iterator                                              pointer;
+        typedef typename std::conditional<
+            std::is_reference<typename iterator_traits<Iterator>::reference>::value,
+            typename std::remove_reference<
+                typename iterator_traits<Iterator>::reference>::type&&,
+            typename iterator_traits<Iterator>::reference>::type      reference;
+
+        typedef Iterator                                              Iterator_type;
+        typedef move_iterator                                         self;
+
+    public:
+        move_iterator() : current() {}
+        explicit move_iterator(Iterator_type i) : current(i) {}
+
+        template <class U>
+        move_iterator(const move_iterator<U> &rhs) : current(rhs.base()) {}
+
+    public:
+        Iterator_type base() const
+        {
+            return current;
+        }
+
+        reference operator*() const
+        {
+            return static_cast<reference>(*current);
+        }
+
+        pointer operator->() const
+        {
+            return current;
+        }
+
+        self& operator++()
+        {
+            ++current;
+            return *this;
+        }
+
+        self operator++(int)
+        {
+            self tmp = *this;
+            ++current;
+            return tmp;
+        }
+
+        self& operator--()
+        {
+            --current;
+            return *this;
+        }
+
+        self operator--(int)
+        {
+            self tmp = *this;
+            --current;
+            return tmp;
+        }
+
+        self& operator+=(difference_type n)
+        {
+            current += n;
+            return *this;
+        }
+        self operator+(difference_type n) const
+        {
+            return self(current + n);
+        }
+        self& operator-=(difference_type n)
+        {
+            current -= n;
+            return *this;
+        }
+        self operator-(difference_type n) const
+        {
+            return self(current - n);
+        }
+
+        reference operator[](difference_type n) const
+        {
+            return static_cast<reference>(current[n]);
+        }
+    };
+
+    // 重载 operator-
+    template <class Iterator>
+    typename move_iterator<Iterator>::difference_type
+    operator-(const move_iterator<Iterator> &lhs, const move_iterator<Iterator> &rhs)
+    {
+        return lhs.base() - rhs.base();
+    }
+
+    // 重载比较操作符
+    template <class Iterator>
+    bool operator==(const move_iterator<Iterator> &lhs, const move_iterator<Iterator> &rhs)
+    {
+        return lhs.base() == rhs.base();
+    }
+
+    template <class Iterator>
+    bool operator!=(const move_iterator<Iterator> &lhs, const move_iterator<Iterator> &rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class Iterator>
+    bool operator<(const move_iterator<Iterator> &lhs, const move_iterator<Iterator> &rhs)
+    {
+        return lhs.base() < rhs.base();
+    }
+
+    template <class Iterator>
+    bool operator>(const move_iterator<Iterator> &lhs, const move_iterator<Iterator> &rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <class Iterator>
+    bool operator<=(const move_iterator<Iterator> &lhs, const move_iterator<Iterator> &rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <class Iterator>
+    bool operator>=(const move_iterator<Iterator> &lhs, const move_iterator<Iterator> &rhs)
+    {
+        return !(lhs < rhs);
+    }
+
+    template <class Iterator>
+    move_iterator<Iterator> make_move_iterator(Iterator i)
+    {
+        return move_iterator<Iterator>(i);
+    }
+
+    /*********************************************************************************************/
+    /*
+     * 模板类: back_insert_iterator / front_insert_iterator
+     * 插入迭代器, 对它赋值即在容器尾部 / 头部插入元素
+     * copy 针对 back_insert_iterator 有重载版本, 源区间可以求长度时一次性插入整个区间
+     */
+    template <class Container>
+    class back_insert_iterator : public iterator<output_iterator_tag, void, void, void, void> {
+    public:
+        typedef Container                     container_type;
+        typedef back_insert_iterator          self;
+
+    protected:
+        Container *container;
+
+    public:
+        explicit back_insert_iterator(Container &x) : container(&x) {}
+
+        Container* get_container() const { return container; }
+
+        self& operator=(const typename Container::value_type &value)
+        {
+            container->push_back(value);
+            return *this;
+        }
+
+        self& operator=(typename Container::value_type &&value)
+        {
+            container->push_back(static_cast<typename Container::value_type&&>(value));
+            return *this;
+        }
+
+        self& operator*()     { return *this; }
+        self& operator++()    { return *this; }
+        self  operator++(int) { return *this; }
+    };
+
+    template <class Container>
+    back_insert_iterator<Container> back_inserter(Container &x)
+    {
+        return back_insert_iterator<Container>(x);
+    }
+
+    template <class Container>
+    class front_insert_iterator : public iterator<output_iterator_tag, void, void, void, void> {
+    public:
+        typedef Container                     container_type;
+        typedef front_insert_iterator         self;
+
+    protected:
+        Container *container;
+
+    public:
+        explicit front_insert_iterator(Container &x) : container(&x) {}
+
+        Container* get_container() const { return container; }
+
+        self& operator=(const typename Container::value_type &value)
+        {
+            container->push_front(value);
+            return *this;
+        }
+
+        self& operator=(typename Container::value_type &&value)
+        {
+            container->push_front(static_cast<typename Container::value_type&&>(value));
+            return *this;
+        }
+
+        self& operator*()     { return *this; }
+        self& operator++()    { return *this; }
+        self  operator++(int) { return *this; }
+    };
+
+    template <class Container>
+    front_insert_iterator<Container> front_inserter(Container &x)
+    {
+        return front_insert_iterator<Container>(x);
+    }
 };
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+/*
+ * 模板类 offset_ptr
+ * 自相对指针: 保存目标地址与自身地址之差, 而不是绝对地址.
+ * 只要指针与目标位于同一块内存中, 这块内存被映射到任何地址 (如不同进程中的共享内存) 都仍然有效.
+ * 偏移为 1 表示空指针 (对象自身地址加 1 不可能是合法的目标)
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace mystl {
+    template <class T>
+    class offset_ptr {
+    public:
+        typedef T          element_type;
+        typedef T*         pointer;
+        typedef T&         reference;
+        typedef ptrdiff_t  difference_type;
+
+    private:
+        difference_type off_;
+
+        static const difference_type null_offset = 1;
+
+        difference_type offset_of(const T *p) const noexcept
+        {
+            return p == nullptr ? null_offset
+                : reinterpret_cast<intptr_t>(p) - reinterpret_cast<intptr_t>(this);
+        }
+
+    public:
+        offset_ptr() noexcept : off_(null_offset) {}
+        offset_ptr(T *p) noexcept : off_(offset_of(p)) {}
+        // 复制时按目标地址重新计算偏移
+        offset_ptr(const offset_ptr &rhs) noexcept : off_(offset_of(rhs.get())) {}
+
+        offset_ptr& operator=(const offset_ptr &rhs) noexcept
+        {
+            off_ = offset_of(rhs.get());
+            return *this;
+        }
+        offset_ptr& operator=(T *p) noexcept
+        {
+            off_ = offset_of(p);
+            return *this;
+        }
+
+        T* get() const noexcept
+        {
+            return off_ == null_offset ? nullptr
+                : reinterpret_cast<T*>(reinterpret_cast<intptr_t>(this) + off_);
+        }
+
+        T&   operator*()  const noexcept { return *get(); }
+        T*   operator->() const noexcept { return get(); }
+        T&   operator[](difference_type n) const noexcept { return get()[n]; }
+        explicit operator bool() const noexcept { return off_ != null_offset; }
+
+        bool operator==(const offset_ptr &rhs) const noexcept { return get() == rhs.get(); }
+        bool operator!=(const offset_ptr &rhs) const noexcept { return get() != rhs.get(); }
+    };
+};
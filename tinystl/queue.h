@@ -0,0 +1,187 @@
+#pragma once
+
+/*
+ * 模板类 priority_queue
+ * 优先队列, 默认以 mystl::deque 为底层容器, 4 叉堆组织元素
+ */
+
+#include <initializer_list>
+
+#include "deque.h"
+#include "functional.h"
+#include "heap_algo.h"
+#include "exceptdef.h"
+
+namespace mystl {
+    // 参数一代表数据类型, 参数二代表底层容器类型, 缺省使用 mystl::deque 作为底层容器
+    // 参数三代表比较权值的方式, 缺省使用 mystl::less 作为比较方式
+    // 参数四代表堆的分叉数, 缺省为 4: 树高减半, 下沉时比较的孩子位于同一缓存行
+    template <class T, class Container = mystl::deque<T>,
+              class Compare = mystl::less<typename Container::value_type>,
+              size_t Arity = 4>
+    class priority_queue {
+        static_assert(Arity >= 2, "priority_queue arity must be at least 2");
+
+    public:
+        typedef Container                              container_type;
+        typedef Compare                                value_compare;
+        // 使用底层容器的型别
+        typedef typename Container::value_type         value_type;
+        typedef typename Container::size_type          size_type;
+        typedef typename Container::reference          reference;
+        typedef typename Container::const_reference    const_reference;
+
+        static constexpr size_t arity = Arity;
+
+    private:
+        container_type c_;     // 用底层容器来表现 priority_queue
+        value_compare  comp_;  // 权值比较的标准
+
+    public:
+        // 构造、复制、移动函数
+        priority_queue() = default;
+
+        explicit priority_queue(const Compare &c)
+            : c_(), comp_(c)
+        {
+        }
+
+        priority_queue(const Compare &c, const Container &s)
+            : c_(s), comp_(c)
+        {
+            mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+        }
+
+        priority_queue(const Compare &c, Container &&s)
+            : c_(mystl::move(s)), comp_(c)
+        {
+            mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+        }
+
+        template <class IIter, typename std::enable_if<
+            mystl::is_input_iterator<IIter>::value, int>::type = 0>
+        priority_queue(IIter first, IIter last)
+            : c_(first, last), comp_()
+        {
+            mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+        }
+
+        priority_queue(std::initializer_list<value_type> ilist)
+            : c_(ilist), comp_()
+        {
+            mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+        }
+
+        priority_queue(const priority_queue &rhs) = default;
+        priority_queue(priority_queue &&rhs) = default;
+
+        priority_queue& operator=(const priority_queue &rhs) = default;
+        priority_queue& operator=(priority_queue &&rhs) = default;
+
+        priority_queue& operator=(std::initializer_list<value_type> ilist)
+        {
+            c_ = ilist;
+            comp_ = value_compare();
+            mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+            return *this;
+        }
+
+        ~priority_queue() = default;
+
+    public:
+        // 访问元素相关操作
+        const_reference top() const
+        {
+            MYSTL_DEBUG(!empty());
+            return c_.front();
+        }
+
+        // 容量相关操作
+        bool      empty() const { return c_.empty(); }
+        size_type size()  const { return c_.size(); }
+
+        // 修改容器相关操作
+        template <class... Args>
+        void emplace(Args&& ...args)
+        {
+            c_.emplace_back(mystl::forward<Args>(args)...);
+            mystl::dary_push_heap<Arity>(c_.begin(), c_.end(), comp_);
+        }
+
+        void push(const value_type &value)
+        {
+            c_.push_back(value);
+            mystl::dary_push_heap<Arity>(c_.begin(), c_.end(), comp_);
+        }
+
+        void push(value_type &&value)
+        {
+            c_.push_back(mystl::move(value));
+            mystl::dary_push_heap<Arity>(c_.begin(), c_.end(), comp_);
+        }
+
+        // 批量插入: 一次性追加到底部容器尾部,
+        // 新元素较多时整体 O(n) 建堆, 否则逐个上溯 O(k log n)
+        template <class IIter, typename std::enable_if<
+            mystl::is_input_iterator<IIter>::value, int>::type = 0>
+        void push_range(IIter first, IIter last)
+        {
+            const size_type old_size = c_.size();
+            c_.insert(c_.end(), first, last);
+            const size_type new_size = c_.size();
+            const size_type added = new_size - old_size;
+            if (added == 0)
+                return;
+
+            // 逐个上溯的代价约为 added * 树高, 整体建堆的代价约为 new_size
+            size_type height = 1;
+            for (size_type n = new_size; n >= Arity; n /= Arity)
+                ++height;
+            if (added * height >= new_size) {
+                mystl::dary_make_heap<Arity>(c_.begin(), c_.end(), comp_);
+            }
+            else {
+                auto first1 = c_.begin();
+                for (size_type i = old_size + 1; i <= new_size; ++i)
+                    mystl::dary_push_heap<Arity>(first1, first1 + i, comp_);
+            }
+        }
+
+        void pop()
+        {
+            MYSTL_DEBUG(!empty());
+            mystl::dary_pop_heap<Arity>(c_.begin(), c_.end(), comp_);
+            c_.pop_back();
+        }
+
+        void clear()
+        {
+            c_.clear();
+        }
+
+        void swap(priority_queue &rhs) noexcept
+        {
+            mystl::swap(c_, rhs.c_);
+            mystl::swap(comp_, rhs.comp_);
+        }
+
+    public:
+        friend bool operator==(const priority_queue &lhs, const priority_queue &rhs)
+        {
+            return lhs.c_ == rhs.c_;
+        }
+
+        friend bool operator!=(const priority_queue &lhs, const priority_queue &rhs)
+        {
+            return lhs.c_ != rhs.c_;
+        }
+    };
+
+    // 重载 mystl 的 swap
+    template <class T, class Container, class Compare, size_t Arity>
+    void swap(priority_queue<T, Container, Compare, Arity> &lhs,
+              priority_queue<T, Container, Compare, Arity> &rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+};
@@ -0,0 +1,222 @@
+#pragma once
+
+/*
+ * set 的两种算法: union / intersection
+ * 要求两个序列都已排序, 两个序列均为随机迭代器时使用 galloping 加速长度悬殊的情况
+ */
+
+#include "algo.h"
+#include "algobase.h"
+#include "iterator.h"
+
+namespace mystl {
+    /*****************************************************************************************/
+    // set_union
+    // 计算 S1∪S2 的结果并保存到 result 中, 返回一个迭代器指向输出结果的尾部
+    /*****************************************************************************************/
+    // 一般版本: 逐个比较
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    OutputIter __set_union(InputIter1 first1, InputIter1 last1,
+                           InputIter2 first2, InputIter2 last2,
+                           OutputIter result, Compare comp,
+                           mystl::input_iterator_tag)
+    {
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first1, *first2)) {
+                *result = *first1;
+                ++first1;
+            }
+            else if (comp(*first2, *first1)) {
+                *result = *first2;
+                ++first2;
+            }
+            else {
+                *result = *first1;
+                ++first1;
+                ++first2;
+            }
+            ++result;
+        }
+        // 将剩余元素拷贝到 result
+        return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
+    }
+
+    // random_access_iterator_tag 版本: 某一序列连续胜出 MYSTL_MIN_GALLOP 次后,
+    // 用指数搜索找出整段严格小于对方当前元素的区间, 整段交给 copy
+    template <class RandomIter1, class RandomIter2, class OutputIter, class Compare>
+    OutputIter __set_union(RandomIter1 first1, RandomIter1 last1,
+                           RandomIter2 first2, RandomIter2 last2,
+                           OutputIter result, Compare comp,
+                           mystl::random_access_iterator_tag)
+    {
+        int win1 = 0, win2 = 0;
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first1, *first2)) {
+                *result = *first1;
+                ++first1;
+                ++result;
+                win2 = 0;
+                if (++win1 >= MYSTL_MIN_GALLOP && first1 != last1) {
+                    auto run_end = mystl::__gallop_lower_bound(first1, last1, *first2, comp);
+                    result = mystl::copy(first1, run_end, result);
+                    first1 = run_end;
+                    win1 = 0;
+                }
+            }
+            else if (comp(*first2, *first1)) {
+                *result = *first2;
+                ++first2;
+                ++result;
+                win1 = 0;
+                if (++win2 >= MYSTL_MIN_GALLOP && first2 != last2) {
+                    auto run_end = mystl::__gallop_lower_bound(first2, last2, *first1, comp);
+                    result = mystl::copy(first2, run_end, result);
+                    first2 = run_end;
+                    win2 = 0;
+                }
+            }
+            else {
+                *result = *first1;
+                ++first1;
+                ++first2;
+                ++result;
+                win1 = win2 = 0;
+            }
+        }
+        return mystl::copy(first2, last2, mystl::copy(first1, last1, result));
+    }
+
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    OutputIter __set_union(InputIter1 first1, InputIter1 last1,
+                           InputIter2 first2, InputIter2 last2,
+                           OutputIter result, Compare comp)
+    {
+        typedef typename std::conditional<
+            mystl::is_random_access_iterator<InputIter1>::value &&
+            mystl::is_random_access_iterator<InputIter2>::value,
+            mystl::random_access_iterator_tag, mystl::input_iterator_tag>::type Category;
+        return mystl::__set_union(first1, last1, first2, last2, result, comp, Category());
+    }
+
+    template <class InputIter1, class InputIter2, class OutputIter>
+    OutputIter set_union(InputIter1 first1, InputIter1 last1,
+                         InputIter2 first2, InputIter2 last2,
+                         OutputIter result)
+    {
+        typedef typename iterator_traits<InputIter1>::value_type value_type;
+        return mystl::__set_union(first1, last1, first2, last2, result,
+                                  [](const value_type &a, const value_type &b) { return a < b; });
+    }
+
+    // 重载版本使用函数对象 comp 代替比较操作
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    OutputIter set_union(InputIter1 first1, InputIter1 last1,
+                         InputIter2 first2, InputIter2 last2,
+                         OutputIter result, Compare comp)
+    {
+        return mystl::__set_union(first1, last1, first2, last2, result, comp);
+    }
+
+    /*****************************************************************************************/
+    // set_intersection
+    // 计算 S1∩S2 的结果并保存到 result 中, 返回一个迭代器指向输出结果的尾部
+    // 输出的元素均取自 S1
+    /*****************************************************************************************/
+    // 一般版本: 逐个比较
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    OutputIter __set_intersection(InputIter1 first1, InputIter1 last1,
+                                  InputIter2 first2, InputIter2 last2,
+                                  OutputIter result, Compare comp,
+                                  mystl::input_iterator_tag)
+    {
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first1, *first2)) {
+                ++first1;
+            }
+            else if (comp(*first2, *first1)) {
+                ++first2;
+            }
+            else {
+                *result = *first1;
+                ++first1;
+                ++first2;
+                ++result;
+            }
+        }
+        return result;
+    }
+
+    // random_access_iterator_tag 版本: 两个序列长度相差 MYSTL_GALLOP_RATIO 倍以上时,
+    // 遍历较短的序列, 在较长的序列中用指数搜索定位, 复杂度 O(m log(n / m))
+    #ifndef MYSTL_GALLOP_RATIO
+    #define MYSTL_GALLOP_RATIO 8
+    #endif
+
+    template <class RandomIter1, class RandomIter2, class OutputIter, class Compare>
+    OutputIter __set_intersection(RandomIter1 first1, RandomIter1 last1,
+                                  RandomIter2 first2, RandomIter2 last2,
+                                  OutputIter result, Compare comp,
+                                  mystl::random_access_iterator_tag)
+    {
+        const auto len1 = last1 - first1;
+        const auto len2 = last2 - first2;
+        if (len2 >= len1 * MYSTL_GALLOP_RATIO) {
+            // S1 较短
+            for (; first1 != last1 && first2 != last2; ++first1) {
+                first2 = mystl::__gallop_lower_bound(first2, last2, *first1, comp);
+                if (first2 != last2 && !comp(*first1, *first2)) {
+                    *result = *first1;
+                    ++result;
+                    ++first2;
+                }
+            }
+            return result;
+        }
+        if (len1 >= len2 * MYSTL_GALLOP_RATIO) {
+            // S2 较短
+            for (; first2 != last2 && first1 != last1; ++first2) {
+                first1 = mystl::__gallop_lower_bound(first1, last1, *first2, comp);
+                if (first1 != last1 && !comp(*first2, *first1)) {
+                    *result = *first1;
+                    ++result;
+                    ++first1;
+                }
+            }
+            return result;
+        }
+        return mystl::__set_intersection(first1, last1, first2, last2, result, comp,
+                                         mystl::input_iterator_tag());
+    }
+
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    OutputIter __set_intersection(InputIter1 first1, InputIter1 last1,
+                                  InputIter2 first2, InputIter2 last2,
+                                  OutputIter result, Compare comp)
+    {
+        typedef typename std::conditional<
+            mystl::is_random_access_iterator<InputIter1>::value &&
+            mystl::is_random_access_iterator<InputIter2>::value,
+            mystl::random_access_iterator_tag, mystl::input_iterator_tag>::type Category;
+        return mystl::__set_intersection(first1, last1, first2, last2, result, comp, Category());
+    }
+
+    template <class InputIter1, class InputIter2, class OutputIter>
+    OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
+                                InputIter2 first2, InputIter2 last2,
+                                OutputIter result)
+    {
+        typedef typename iterator_traits<InputIter1>::value_type value_type;
+        return mystl::__set_intersection(first1, last1, first2, last2, result,
+                                         [](const value_type &a, const value_type &b)
+                                         { return a < b; });
+    }
+
+    // 重载版本使用函数对象 comp 代替比较操作
+    template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+    OutputIter set_intersection(InputIter1 first1, InputIter1 last1,
+                                InputIter2 first2, InputIter2 last2,
+                                OutputIter result, Compare comp)
+    {
+        return mystl::__set_intersection(first1, last1, first2, last2, result, comp);
+    }
+};
@@ -0,0 +1,487 @@
+#pragma once
+
+/*
+ * 模板类 shm_deque
+ * 位于 POSIX 共享内存中的双端队列, 可在同一台机器的多个进程间直接传递元素, 元素须是可平凡复制的类型.
+ * 整个队列 (头部、缓冲区映射表、缓冲区) 都在一块 shm_open/mmap 得到的区域中, 区域内的指针一律用 offset_ptr,
+ * 各进程把区域映射到不同地址也能正常使用. 缓冲区由区域内的定长块分配器分配;
+ * 映射表是固定容量的环形数组, 容量等于区域能容纳的最大块数, 无需重新分配.
+ * 所有操作由区域中的进程共享 (robust) 互斥锁保护. 持锁进程在修改队列的中途退出时队列可能处于不一致状态,
+ * 此后所有操作都抛出异常, 只能删除并重建区域; 持锁进程在只读操作中退出则不受影响.
+ * 仅支持 POSIX 系统, 链接时可能需要 -lrt -pthread
+ */
+
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <new>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <type_traits>
+#include <unistd.h>
+
+#include "deque.h"
+#include "exceptdef.h"
+#include "offset_ptr.h"
+#include "util.h"
+
+namespace mystl {
+    template <class T, size_t BlockBytes = 0>
+    class shm_deque {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "shm_deque<T> requires a trivially copyable T");
+
+    public:
+        typedef T          value_type;
+        typedef size_t     size_type;
+
+        static const size_type buffer_size = deque_buf_size<T, BlockBytes>::value;
+
+    private:
+        static const size_type block_bytes = buffer_size * sizeof(T);
+
+        // 空闲块链表的节点, 存放在空闲块的开头
+        struct free_node {
+            offset_ptr<free_node> next;
+        };
+
+        // 区域头部, 位于区域起点
+        struct header {
+            char                  magic[8];
+            uint32_t              value_size;
+            uint32_t              block_bytes;
+            uint64_t              region_size;
+            std::atomic<uint32_t> ready;       // 创建者初始化完毕后置 1
+            std::atomic<uint32_t> dirty;       // 正在修改队列时为 1
+            pthread_mutex_t       mutex;
+
+            // 块分配器: 先取空闲链表, 再从未用过的区域切分
+            offset_ptr<char>      bump;
+            offset_ptr<char>      limit;
+            offset_ptr<free_node> free_list;
+
+            // 队列状态
+            offset_ptr<offset_ptr<T>> map;     // 环形映射表
+            uint64_t              map_cap;
+            uint64_t              map_head;    // 第一块在映射表中的位置
+            uint64_t              nblocks;
+            uint64_t              head;        // 第一个元素在第一块中的位置
+            uint64_t              size;
+        };
+
+        // 持锁期间的守卫, write 为 true 时在持锁期间置 dirty.
+        // 持锁进程异常退出后, 下一个加锁者在 dirty 未置位时恢复锁的一致性;
+        // dirty 已置位说明队列修改到一半, 此时不恢复而直接解锁, 锁随之永久不可用, 加锁者都会抛出异常
+        class lock_guard {
+        public:
+            lock_guard(header *h, bool write) : h_(h), write_(write)
+            {
+                const int rc = pthread_mutex_lock(&h_->mutex);
+                if (rc == EOWNERDEAD) {
+                    if (h_->dirty.load(std::memory_order_relaxed) != 0) {
+                        pthread_mutex_unlock(&h_->mutex);
+                        THROW_RUNTIME_ERROR_IF(true, "shm_deque<T>'s region is unrecoverable");
+                    }
+                    pthread_mutex_consistent(&h_->mutex);
+                }
+                else {
+                    THROW_RUNTIME_ERROR_IF(rc == ENOTRECOVERABLE, "shm_deque<T>'s region is unrecoverable");
+                    THROW_RUNTIME_ERROR_IF(rc != 0, "shm_deque<T> failed to lock");
+                }
+                // 信号栅栏阻止编译器把对队列的写入移到 dirty 的写入之前或之后
+                if (write_) {
+                    h_->dirty.store(1, std::memory_order_relaxed);
+                    std::atomic_signal_fence(std::memory_order_seq_cst);
+                }
+            }
+            ~lock_guard()
+            {
+                if (write_) {
+                    std::atomic_signal_fence(std::memory_order_seq_cst);
+                    h_->dirty.store(0, std::memory_order_relaxed);
+                }
+                pthread_mutex_unlock(&h_->mutex);
+            }
+
+            lock_guard(const lock_guard&) = delete;
+            lock_guard& operator=(const lock_guard&) = delete;
+
+        private:
+            header *h_;
+            bool    write_;
+        };
+
+        header    *h_;
+        size_type  map_size_;
+
+    public:
+        // 创建名为 name 的共享内存区域, 大小为 bytes; 同名区域已存在时抛出异常
+        static shm_deque create(const char *name, size_type bytes);
+
+        // 打开其它进程创建的区域, 等待其初始化完成
+        static shm_deque open(const char *name);
+
+        // 删除区域的名字, 已映射的进程不受影响
+        static void      unlink(const char *name) noexcept { ::shm_unlink(name); }
+
+        shm_deque(const shm_deque&) = delete;
+        shm_deque& operator=(const shm_deque&) = delete;
+
+        shm_deque(shm_deque &&rhs) noexcept
+            : h_(rhs.h_), map_size_(rhs.map_size_)
+        {
+            rhs.h_ = nullptr;
+            rhs.map_size_ = 0;
+        }
+
+        shm_deque& operator=(shm_deque &&rhs) noexcept
+        {
+            if (this != &rhs) {
+                detach();
+                h_ = rhs.h_;
+                map_size_ = rhs.map_size_;
+                rhs.h_ = nullptr;
+                rhs.map_size_ = 0;
+            }
+            return *this;
+        }
+
+        // 只解除本进程的映射, 区域中的数据保留
+        ~shm_deque()
+        {
+            detach();
+        }
+
+    public:
+        // 容量相关操作, 结果可能随即被其它进程改变
+        size_type size() const
+        {
+            lock_guard lock(h_, false);
+            return static_cast<size_type>(h_->size);
+        }
+        bool      empty() const { return size() == 0; }
+
+        // 区域能容纳的最大块数
+        size_type max_blocks() const noexcept { return static_cast<size_type>(h_->map_cap); }
+
+        // 修改容器相关操作, 区域已满时 push 返回 false, 队列为空时 pop 返回 false
+        bool      push_back(const value_type &value)
+        {
+            lock_guard lock(h_, true);
+            return push_back_locked(value);
+        }
+        bool      push_front(const value_type &value)
+        {
+            lock_guard lock(h_, true);
+            return push_front_locked(value);
+        }
+        bool      pop_front(value_type &out)
+        {
+            lock_guard lock(h_, true);
+            return pop_front_locked(out);
+        }
+        bool      pop_back(value_type &out)
+        {
+            lock_guard lock(h_, true);
+            return pop_back_locked(out);
+        }
+
+        // 批量操作只加一次锁, 返回实际放入/取出的个数
+        size_type push_back_n(const value_type *first, size_type n)
+        {
+            lock_guard lock(h_, true);
+            size_type i = 0;
+            while (i < n && push_back_locked(first[i]))
+                ++i;
+            return i;
+        }
+        size_type pop_front_n(value_type *result, size_type n)
+        {
+            lock_guard lock(h_, true);
+            size_type i = 0;
+            while (i < n && pop_front_locked(result[i]))
+                ++i;
+            return i;
+        }
+
+        void      clear()
+        {
+            lock_guard lock(h_, true);
+            while (h_->nblocks != 0)
+                pop_block_back();
+            h_->head = h_->size = 0;
+        }
+
+    private:
+        explicit shm_deque(header *h, size_type map_size) noexcept
+            : h_(h), map_size_(map_size)
+        {
+        }
+
+        void      detach() noexcept
+        {
+            if (h_ != nullptr)
+                ::munmap(h_, map_size_);
+            h_ = nullptr;
+        }
+
+        // helper functions
+        static void init_region(header *h, size_type bytes);
+
+        T*        allocate_block() noexcept;
+        void      deallocate_block(T *p) noexcept;
+
+        offset_ptr<T>& map_at(uint64_t i) const noexcept
+        {
+            return h_->map.get()[(h_->map_head + i) % h_->map_cap];
+        }
+        T*        element(uint64_t pos) const noexcept
+        {
+            return map_at(pos / buffer_size).get() + pos % buffer_size;
+        }
+
+        void      pop_block_front() noexcept;
+        void      pop_block_back() noexcept;
+
+        bool      push_back_locked(const value_type &value) noexcept;
+        bool      push_front_locked(const value_type &value) noexcept;
+        bool      pop_front_locked(value_type &out) noexcept;
+        bool      pop_back_locked(value_type &out) noexcept;
+    };
+
+    /*****************************************************************************************/
+
+    template <class T, size_t BlockBytes>
+    shm_deque<T, BlockBytes> shm_deque<T, BlockBytes>::create(const char *name, size_type bytes)
+    {
+        THROW_LENGTH_ERROR_IF(bytes < sizeof(header) + block_bytes + sizeof(offset_ptr<T>),
+                              "shm_deque<T>'s region is too small");
+        const int fd = ::shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+        THROW_RUNTIME_ERROR_IF(fd < 0, "shm_deque<T> failed to create the region");
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            ::close(fd);
+            ::shm_unlink(name);
+            THROW_RUNTIME_ERROR_IF(true, "shm_deque<T> failed to size the region");
+        }
+        void *p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            ::shm_unlink(name);
+            THROW_RUNTIME_ERROR_IF(true, "shm_deque<T> failed to map the region");
+        }
+        header *h = static_cast<header*>(p);
+        try {
+            init_region(h, bytes);
+        }
+        catch (...) {
+            ::munmap(p, bytes);
+            ::shm_unlink(name);
+            throw;
+        }
+        return shm_deque(h, bytes);
+    }
+
+    template <class T, size_t BlockBytes>
+    shm_deque<T, BlockBytes> shm_deque<T, BlockBytes>::open(const char *name)
+    {
+        const int fd = ::shm_open(name, O_RDWR, 0600);
+        THROW_RUNTIME_ERROR_IF(fd < 0, "shm_deque<T> failed to open the region");
+        // 创建者可能尚未设置大小
+        struct stat st;
+        for (;;) {
+            if (::fstat(fd, &st) != 0) {
+                ::close(fd);
+                THROW_RUNTIME_ERROR_IF(true, "shm_deque<T> failed to stat the region");
+            }
+            if (static_cast<size_type>(st.st_size) >= sizeof(header))
+                break;
+            std::this_thread::yield();
+        }
+        const size_type bytes = static_cast<size_type>(st.st_size);
+        void *p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        THROW_RUNTIME_ERROR_IF(p == MAP_FAILED, "shm_deque<T> failed to map the region");
+        header *h = static_cast<header*>(p);
+        while (h->ready.load(std::memory_order_acquire) == 0)
+            std::this_thread::yield();
+        if (h->value_size != sizeof(T) || h->block_bytes != block_bytes) {
+            ::munmap(p, bytes);
+            THROW_RUNTIME_ERROR_IF(true, "shm_deque<T> region does not match the element type");
+        }
+        return shm_deque(h, bytes);
+    }
+
+    /*****************************************************************************************/
+    // helper function
+
+    // 布局: 头部 | 映射表 | 块区, 映射表容量等于块区能容纳的块数
+    template <class T, size_t BlockBytes>
+    void shm_deque<T, BlockBytes>::init_region(header *h, size_type bytes)
+    {
+        const char magic[8] = {'M', 'Y', 'S', 'T', 'L', 'S', 'Q', '\0'};
+        memcpy(h->magic, magic, sizeof(magic));
+        h->value_size = sizeof(T);
+        h->block_bytes = static_cast<uint32_t>(block_bytes);
+        h->region_size = bytes;
+
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+        const int rc = pthread_mutex_init(&h->mutex, &attr);
+        pthread_mutexattr_destroy(&attr);
+        THROW_RUNTIME_ERROR_IF(rc != 0, "shm_deque<T> failed to initialize the mutex");
+
+        const size_type align = alignof(T) > alignof(free_node) ? alignof(T) : alignof(free_node);
+        char *base = reinterpret_cast<char*>(h);
+        const size_type map_off = (sizeof(header) + alignof(offset_ptr<T>) - 1) & ~(alignof(offset_ptr<T>) - 1);
+        // 估算块数, 再扣除映射表与对齐所占的空间
+        size_type cap = (bytes - map_off) / (block_bytes + sizeof(offset_ptr<T>));
+        size_type blocks_off = 0;
+        for (;;) {
+            blocks_off = (map_off + cap * sizeof(offset_ptr<T>) + align - 1) & ~(align - 1);
+            if (blocks_off + cap * block_bytes <= bytes || cap == 0)
+                break;
+            --cap;
+        }
+        THROW_LENGTH_ERROR_IF(cap == 0, "shm_deque<T>'s region is too small");
+
+        offset_ptr<T> *map = reinterpret_cast<offset_ptr<T>*>(base + map_off);
+        for (size_type i = 0; i < cap; ++i)
+            ::new (static_cast<void*>(map + i)) offset_ptr<T>();
+        ::new (static_cast<void*>(&h->bump)) offset_ptr<char>(base + blocks_off);
+        ::new (static_cast<void*>(&h->limit)) offset_ptr<char>(base + blocks_off + cap * block_bytes);
+        ::new (static_cast<void*>(&h->free_list)) offset_ptr<free_node>();
+        ::new (static_cast<void*>(&h->map)) offset_ptr<offset_ptr<T>>(map);
+        h->map_cap = cap;
+        h->map_head = 0;
+        h->nblocks = 0;
+        h->head = 0;
+        h->size = 0;
+        h->dirty.store(0, std::memory_order_relaxed);
+        h->ready.store(1, std::memory_order_release);
+    }
+
+    template <class T, size_t BlockBytes>
+    T* shm_deque<T, BlockBytes>::allocate_block() noexcept
+    {
+        free_node *n = h_->free_list.get();
+        if (n != nullptr) {
+            h_->free_list = n->next.get();
+            return reinterpret_cast<T*>(n);
+        }
+        char *p = h_->bump.get();
+        if (p == h_->limit.get())
+            return nullptr;
+        h_->bump = p + block_bytes;
+        return reinterpret_cast<T*>(p);
+    }
+
+    template <class T, size_t BlockBytes>
+    void shm_deque<T, BlockBytes>::deallocate_block(T *p) noexcept
+    {
+        free_node *n = ::new (static_cast<void*>(p)) free_node;
+        n->next = h_->free_list.get();
+        h_->free_list = n;
+    }
+
+    template <class T, size_t BlockBytes>
+    void shm_deque<T, BlockBytes>::pop_block_front() noexcept
+    {
+        offset_ptr<T> &slot = map_at(0);
+        deallocate_block(slot.get());
+        slot = nullptr;
+        h_->map_head = (h_->map_head + 1) % h_->map_cap;
+        --h_->nblocks;
+    }
+
+    template <class T, size_t BlockBytes>
+    void shm_deque<T, BlockBytes>::pop_block_back() noexcept
+    {
+        offset_ptr<T> &slot = map_at(h_->nblocks - 1);
+        deallocate_block(slot.get());
+        slot = nullptr;
+        --h_->nblocks;
+    }
+
+    template <class T, size_t BlockBytes>
+    bool shm_deque<T, BlockBytes>::push_back_locked(const value_type &value) noexcept
+    {
+        const uint64_t tail = h_->head + h_->size;
+        if (tail == h_->nblocks * buffer_size) {
+            if (h_->nblocks == h_->map_cap)
+                return false;
+            T *b = allocate_block();
+            if (b == nullptr)
+                return false;
+            map_at(h_->nblocks) = b;
+            ++h_->nblocks;
+        }
+        memcpy(static_cast<void*>(element(tail)), &value, sizeof(T));
+        ++h_->size;
+        return true;
+    }
+
+    template <class T, size_t BlockBytes>
+    bool shm_deque<T, BlockBytes>::push_front_locked(const value_type &value) noexcept
+    {
+        if (h_->head == 0) {
+            if (h_->nblocks == h_->map_cap)
+                return false;
+            T *b = allocate_block();
+            if (b == nullptr)
+                return false;
+            h_->map_head = (h_->map_head + h_->map_cap - 1) % h_->map_cap;
+            map_at(0) = b;
+            ++h_->nblocks;
+            h_->head = buffer_size;
+        }
+        memcpy(static_cast<void*>(element(h_->head - 1)), &value, sizeof(T));
+        --h_->head;
+        ++h_->size;
+        return true;
+    }
+
+    template <class T, size_t BlockBytes>
+    bool shm_deque<T, BlockBytes>::pop_front_locked(value_type &out) noexcept
+    {
+        if (h_->size == 0)
+            return false;
+        memcpy(static_cast<void*>(&out), element(h_->head), sizeof(T));
+        ++h_->head;
+        --h_->size;
+        if (h_->size == 0) {
+            while (h_->nblocks != 0)
+                pop_block_back();
+            h_->head = 0;
+        }
+        else if (h_->head == buffer_size) {
+            pop_block_front();
+            h_->head = 0;
+        }
+        return true;
+    }
+
+    template <class T, size_t BlockBytes>
+    bool shm_deque<T, BlockBytes>::pop_back_locked(value_type &out) noexcept
+    {
+        if (h_->size == 0)
+            return false;
+        const uint64_t last = h_->head + h_->size - 1;
+        memcpy(static_cast<void*>(&out), element(last), sizeof(T));
+        --h_->size;
+        if (h_->size == 0) {
+            while (h_->nblocks != 0)
+                pop_block_back();
+            h_->head = 0;
+        }
+        else if (last % buffer_size == 0) {
+            pop_block_back();
+        }
+        return true;
+    }
+};
@@ -0,0 +1,437 @@
+#pragma once
+
+/*
+ * 模板类 small_deque
+ * 前 N 个元素以环形缓冲区的形式存放在对象内部, 不申请任何堆内存;
+ * 元素个数超过 N 时才把元素搬到 mystl::deque 中, 此后一直使用 deque
+ */
+
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+
+#include "deque.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "util.h"
+
+namespace mystl {
+    template <class T, size_t N>
+    class small_deque;
+
+    // small_deque 的迭代器: 以容器指针 + 下标表示, 随机访问
+    template <class T, size_t N, class Ref, class Ptr>
+    struct small_deque_iterator : public iterator<random_access_iterator_tag, T> {
+        typedef small_deque_iterator<T, N, T&, T*>              iterator;
+        typedef small_deque_iterator<T, N, const T&, const T*>  const_iterator;
+        typedef small_deque_iterator                            self;
+
+        typedef T          value_type;
+        typedef Ptr        pointer;
+        typedef Ref        reference;
+        typedef size_t     size_type;
+        typedef ptrdiff_t  difference_type;
+
+        typedef typename std::conditional<std::is_const<typename std::remove_reference<Ref>::type>::value,
+            const small_deque<T, N>*, small_deque<T, N>*>::type container_pointer;
+
+        container_pointer c;     // 所属容器
+        size_type         index; // 元素下标
+
+        small_deque_iterator() noexcept : c(nullptr), index(0) {}
+        small_deque_iterator(container_pointer x, size_type i) noexcept : c(x), index(i) {}
+        small_deque_iterator(const iterator &rhs) noexcept : c(rhs.c), index(rhs.index) {}
+
+        self& operator=(const iterator &rhs) noexcept
+        {
+            c = rhs.c;
+            index = rhs.index;
+            return *this;
+        }
+
+        reference operator*()  const { return (*c)[index]; }
+        pointer   operator->() const { return &(operator*()); }
+
+        difference_type operator-(const self &x) const
+        {
+            return static_cast<difference_type>(index) - static_cast<difference_type>(x.index);
+        }
+
+        self& operator++() { ++index; return *this; }
+        self  operator++(int)
+        {
+            self tmp = *this;
+            ++index;
+            return tmp;
+        }
+        self& operator--() { --index; return *this; }
+        self  operator--(int)
+        {
+            self tmp = *this;
+            --index;
+            return tmp;
+        }
+
+        self& operator+=(difference_type n) { index += n; return *this; }
+        self  operator+(difference_type n) const
+        {
+            self tmp = *this;
+            return tmp += n;
+        }
+        self& operator-=(difference_type n) { return *this += -n; }
+        self  operator-(difference_type n) const
+        {
+            self tmp = *this;
+            return tmp -= n;
+        }
+
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        bool operator==(const self &rhs) const { return index == rhs.index; }
+        bool operator!=(const self &rhs) const { return index != rhs.index; }
+        bool operator< (const self &rhs) const { return index < rhs.index; }
+        bool operator> (const self &rhs) const { return rhs < *this; }
+        bool operator<=(const self &rhs) const { return !(rhs < *this); }
+        bool operator>=(const self &rhs) const { return !(*this < rhs); }
+    };
+
+    // 模板类 small_deque
+    // 参数一代表数据类型, 参数二代表对象内部可存放的元素个数
+    template <class T, size_t N = 8>
+    class small_deque {
+        static_assert(N > 0, "small_deque inline capacity must be positive");
+
+    public:
+        typedef mystl::deque<T>                          large_type;
+
+        typedef T                                        value_type;
+        typedef T*                                       pointer;
+        typedef const T*                                 const_pointer;
+        typedef T&                                       reference;
+        typedef const T&                                 const_reference;
+        typedef size_t                                   size_type;
+        typedef ptrdiff_t                                difference_type;
+
+        typedef small_deque_iterator<T, N, T&, T*>             iterator;
+        typedef small_deque_iterator<T, N, const T&, const T*> const_iterator;
+        typedef mystl::reverse_iterator<iterator>        reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+        static const size_type inline_capacity = N;
+
+        // 内部存储的元素须逐个移动, 移动操作是否 noexcept 取决于 T
+        static constexpr bool nothrow_move = std::is_nothrow_move_constructible<T>::value;
+
+    private:
+        static const size_t storage_size = sizeof(T) * N > sizeof(large_type)
+            ? sizeof(T) * N : sizeof(large_type);
+        static const size_t storage_align = alignof(T) > alignof(large_type)
+            ? alignof(T) : alignof(large_type);
+
+        // 未溢出时存放环形缓冲区, 溢出后存放 deque 对象
+        typename std::aligned_storage<storage_size, storage_align>::type storage_;
+        size_type head_;   // 环形缓冲区中第一个元素的位置
+        size_type size_;   // 环形缓冲区中的元素个数
+        bool      large_;  // 是否已经转为使用 deque
+
+    public:
+        // 构造、复制、移动、析构函数
+        small_deque() noexcept
+            : head_(0), size_(0), large_(false)
+        {
+        }
+
+        small_deque(size_type n, const value_type &value)
+            : head_(0), size_(0), large_(false)
+        {
+            for (; n > 0; --n)
+                push_back(value);
+        }
+
+        template <class IIter, typename std::enable_if<
+            mystl::is_input_iterator<IIter>::value, int>::type = 0>
+        small_deque(IIter first, IIter last)
+            : head_(0), size_(0), large_(false)
+        {
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+
+        small_deque(std::initializer_list<value_type> ilist)
+            : small_deque(ilist.begin(), ilist.end())
+        {
+        }
+
+        // 元素个数不超过 N 时复制结果总是存放在对象内部
+        small_deque(const small_deque &rhs)
+            : head_(0), size_(0), large_(false)
+        {
+            if (rhs.size() > N) {
+                ::new (static_cast<void*>(&storage_)) large_type(rhs.begin(), rhs.end());
+                large_ = true;
+            }
+            else {
+                for (size_type i = 0; i < rhs.size(); ++i)
+                    push_back(rhs[i]);
+            }
+        }
+
+        small_deque(small_deque &&rhs) noexcept(nothrow_move)
+            : head_(0), size_(0), large_(false)
+        {
+            steal(rhs);
+        }
+
+        small_deque& operator=(const small_deque &rhs)
+        {
+            if (this != &rhs) {
+                small_deque tmp(rhs);
+                reset();
+                steal(tmp);
+            }
+            return *this;
+        }
+
+        small_deque& operator=(small_deque &&rhs) noexcept(nothrow_move)
+        {
+            if (this != &rhs) {
+                reset();
+                steal(rhs);
+            }
+            return *this;
+        }
+
+        ~small_deque()
+        {
+            reset();
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator               begin()         noexcept { return iterator(this, 0); }
+        const_iterator         begin()   const noexcept { return const_iterator(this, 0); }
+        iterator               end()           noexcept { return iterator(this, size()); }
+        const_iterator         end()     const noexcept { return const_iterator(this, size()); }
+
+        reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator         cbegin()  const noexcept { return begin(); }
+        const_iterator         cend()    const noexcept { return end(); }
+
+        // 容量相关操作
+        bool      empty()     const noexcept { return size() == 0; }
+        size_type size()      const noexcept { return large_ ? large().size() : size_; }
+        bool      is_inline() const noexcept { return !large_; }
+
+        // 访问元素相关操作
+        reference       operator[](size_type n)
+        {
+            MYSTL_DEBUG(n < size());
+            return large_ ? large()[n] : slot(n);
+        }
+        const_reference operator[](size_type n) const
+        {
+            MYSTL_DEBUG(n < size());
+            return large_ ? large()[n] : slot(n);
+        }
+
+        reference       at(size_type n)
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "small_deque<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+        const_reference at(size_type n) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "small_deque<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        reference       front()       { MYSTL_DEBUG(!empty()); return (*this)[0]; }
+        const_reference front() const { MYSTL_DEBUG(!empty()); return (*this)[0]; }
+        reference       back()        { MYSTL_DEBUG(!empty()); return (*this)[size() - 1]; }
+        const_reference back()  const { MYSTL_DEBUG(!empty()); return (*this)[size() - 1]; }
+
+        // 修改容器相关操作
+        // 缓冲区已满时先构造出新元素再搬迁, args 可能引用容器中的元素
+        template <class ...Args>
+        void emplace_back(Args&& ...args)
+        {
+            if (!large_ && size_ == N) {
+                value_type tmp(mystl::forward<Args>(args)...);
+                spill();
+                large().emplace_back(mystl::move(tmp));
+            }
+            else if (large_) {
+                large().emplace_back(mystl::forward<Args>(args)...);
+            }
+            else {
+                mystl::construct(&slot(size_), mystl::forward<Args>(args)...);
+                ++size_;
+            }
+        }
+
+        template <class ...Args>
+        void emplace_front(Args&& ...args)
+        {
+            if (!large_ && size_ == N) {
+                value_type tmp(mystl::forward<Args>(args)...);
+                spill();
+                large().emplace_front(mystl::move(tmp));
+            }
+            else if (large_) {
+                large().emplace_front(mystl::forward<Args>(args)...);
+            }
+            else {
+                const size_type new_head = head_ == 0 ? N - 1 : head_ - 1;
+                mystl::construct(data() + new_head, mystl::forward<Args>(args)...);
+                head_ = new_head;
+                ++size_;
+            }
+        }
+
+        void push_back(const value_type &value)  { emplace_back(value); }
+        void push_back(value_type &&value)       { emplace_back(mystl::move(value)); }
+        void push_front(const value_type &value) { emplace_front(value); }
+        void push_front(value_type &&value)      { emplace_front(mystl::move(value)); }
+
+        void pop_front()
+        {
+            MYSTL_DEBUG(!empty());
+            if (large_) {
+                large().pop_front();
+            }
+            else {
+                mystl::destroy(data() + head_);
+                head_ = head_ + 1 == N ? 0 : head_ + 1;
+                --size_;
+            }
+        }
+
+        void pop_back()
+        {
+            MYSTL_DEBUG(!empty());
+            if (large_) {
+                large().pop_back();
+            }
+            else {
+                mystl::destroy(&slot(size_ - 1));
+                --size_;
+            }
+        }
+
+        // 已转为 deque 时保留 deque 及其缓冲区
+        void clear()
+        {
+            if (large_) {
+                large().clear();
+            }
+            else {
+                while (size_ != 0)
+                    pop_back();
+                head_ = 0;
+            }
+        }
+
+        void swap(small_deque &rhs) noexcept(nothrow_move)
+        {
+            if (this != &rhs) {
+                small_deque tmp(mystl::move(rhs));
+                rhs.steal(*this);
+                steal(tmp);
+            }
+        }
+
+    private:
+        // helper functions
+        T*              data()       noexcept { return reinterpret_cast<T*>(&storage_); }
+        const T*        data() const noexcept { return reinterpret_cast<const T*>(&storage_); }
+        large_type&     large()       noexcept { return *reinterpret_cast<large_type*>(&storage_); }
+        const large_type& large() const noexcept { return *reinterpret_cast<const large_type*>(&storage_); }
+
+        // 环形缓冲区中第 n 个元素
+        reference       slot(size_type n) noexcept
+        {
+            const size_type i = head_ + n;
+            return data()[i >= N ? i - N : i];
+        }
+        const_reference slot(size_type n) const noexcept
+        {
+            const size_type i = head_ + n;
+            return data()[i >= N ? i - N : i];
+        }
+
+        // 环形缓冲区已满, 把元素按顺序搬到 deque 中, 之后 storage_ 改为存放 deque
+        // 移动构造可能抛出异常时改为复制, 失败时内部存储的元素保持不变
+        void spill()
+        {
+            large_type tmp;
+            tmp.reserve_back(2 * N);
+            for (size_type i = 0; i < size_; ++i)
+                tmp.emplace_back(mystl::move_if_noexcept(slot(i)));
+            while (size_ != 0)
+                pop_back();
+            head_ = 0;
+            ::new (static_cast<void*>(&storage_)) large_type(mystl::move(tmp));
+            large_ = true;
+        }
+
+        // 析构所有元素, 回到内部存储的空状态
+        void reset() noexcept
+        {
+            if (large_) {
+                large().~large_type();
+                large_ = false;
+            }
+            else {
+                while (size_ != 0)
+                    pop_back();
+            }
+            head_ = 0;
+        }
+
+        // *this 为内部存储的空状态, 取走 rhs 的全部元素, rhs 随后回到空状态;
+        // 移动元素时抛出异常则 *this 回到空状态
+        void steal(small_deque &rhs)
+        {
+            if (rhs.large_) {
+                ::new (static_cast<void*>(&storage_)) large_type(mystl::move(rhs.large()));
+                large_ = true;
+            }
+            else {
+                try {
+                    for (; size_ < rhs.size_; ++size_)
+                        mystl::construct(data() + size_, mystl::move(rhs.slot(size_)));
+                }
+                catch (...) {
+                    reset();
+                    throw;
+                }
+            }
+            rhs.reset();
+        }
+    };
+
+    // 重载比较操作符
+    template <class T, size_t N>
+    bool operator==(const small_deque<T, N> &lhs, const small_deque<T, N> &rhs)
+    {
+        return lhs.size() == rhs.size() &&
+            mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, size_t N>
+    bool operator!=(const small_deque<T, N> &lhs, const small_deque<T, N> &rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    // 重载 mystl 的 swap
+    template <class T, size_t N>
+    void swap(small_deque<T, N> &lhs, small_deque<T, N> &rhs) noexcept(noexcept(lhs.swap(rhs)))
+    {
+        lhs.swap(rhs);
+    }
+};
@@ -0,0 +1,428 @@
+#pragma once
+
+/*
+ * 模板类 spill_deque
+ * 可溢出到磁盘的双端队列, 元素须是可平凡复制的类型. 与 deque 一样按块存放元素,
+ * 常驻内存的块数受内存预算限制: 超出预算时把中间的块写入一个临时的溢出文件,
+ * 队头、队尾所在的块始终常驻; 消费者前进到某块时再把它读回, 并对其后的若干块预读.
+ * 仅支持 POSIX 系统
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/types.h>
+#include <type_traits>
+#include <unistd.h>
+
+#include "allocator.h"
+#include "construct.h"
+#include "deque.h"
+#include "exceptdef.h"
+#include "util.h"
+
+// 每块的字节数, 较大的块可减少读写文件的次数
+#ifndef SPILL_DEQUE_BLOCK_BYTES
+#define SPILL_DEQUE_BLOCK_BYTES 65536
+#endif
+
+// 默认的内存预算
+#ifndef SPILL_DEQUE_DEFAULT_BUDGET
+#define SPILL_DEQUE_DEFAULT_BUDGET (64 * 1024 * 1024)
+#endif
+
+// 队头之后预读的块数
+#ifndef SPILL_DEQUE_READ_AHEAD
+#define SPILL_DEQUE_READ_AHEAD 4
+#endif
+
+namespace mystl {
+    template <class T, size_t BlockBytes = SPILL_DEQUE_BLOCK_BYTES>
+    class spill_deque {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "spill_deque<T> requires a trivially copyable T");
+
+    public:
+        typedef T          value_type;
+        typedef T*         pointer;
+        typedef const T*   const_pointer;
+        typedef T&         reference;
+        typedef const T&   const_reference;
+        typedef size_t     size_type;
+
+        static const size_type buffer_size = deque_buf_size<T, BlockBytes>::value;
+
+    private:
+        typedef mystl::allocator<T> data_allocator;
+
+        // data 为空时块在溢出文件的 offset 处
+        struct block {
+            pointer data;
+            off_t   offset;
+        };
+
+        static const size_type block_bytes = buffer_size * sizeof(T);
+        static const size_type min_budget = 3;  // 队头块、队尾块, 外加一块周转
+
+        mystl::deque<block> blocks_;
+        size_type           head_;              // 队头元素在第一块中的下标
+        size_type           size_;
+        size_type           resident_;          // 常驻内存的块数
+        size_type           budget_;            // 常驻块数的上限
+        pointer             spare_;             // 缓存一块空闲内存
+        int                 fd_;                // 溢出文件, 首次溢出时创建
+        off_t               file_end_;
+        mystl::deque<off_t> free_offsets_;      // 文件中可复用的位置
+        std::string         dir_;
+
+    public:
+        // memory_budget 为元素占用内存的上限 (字节), dir 为溢出文件所在的目录, 为空时取 $TMPDIR 或 /tmp
+        explicit spill_deque(size_type memory_budget = SPILL_DEQUE_DEFAULT_BUDGET,
+                             const char *dir = nullptr)
+            : head_(0), size_(0), resident_(0), budget_(memory_budget / block_bytes),
+              spare_(nullptr), fd_(-1), file_end_(0), dir_(dir != nullptr ? dir : "")
+        {
+            if (budget_ < min_budget)
+                budget_ = min_budget;
+        }
+
+        spill_deque(const spill_deque&) = delete;
+        spill_deque& operator=(const spill_deque&) = delete;
+
+        spill_deque(spill_deque &&rhs) noexcept
+            : blocks_(mystl::move(rhs.blocks_)), head_(rhs.head_), size_(rhs.size_),
+              resident_(rhs.resident_), budget_(rhs.budget_), spare_(rhs.spare_), fd_(rhs.fd_),
+              file_end_(rhs.file_end_), free_offsets_(mystl::move(rhs.free_offsets_)),
+              dir_(mystl::move(rhs.dir_))
+        {
+            rhs.head_ = rhs.size_ = rhs.resident_ = 0;
+            rhs.spare_ = nullptr;
+            rhs.fd_ = -1;
+            rhs.file_end_ = 0;
+        }
+
+        spill_deque& operator=(spill_deque &&rhs) noexcept
+        {
+            if (this != &rhs) {
+                spill_deque tmp(mystl::move(rhs));
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        ~spill_deque()
+        {
+            clear();
+            if (spare_ != nullptr)
+                data_allocator::deallocate(spare_, buffer_size);
+            if (fd_ >= 0)
+                ::close(fd_);
+        }
+
+    public:
+        // 访问元素相关操作, 队头与队尾总在内存中
+        reference       front()       { MYSTL_DEBUG(!empty()); return blocks_.front().data[head_]; }
+        const_reference front() const { MYSTL_DEBUG(!empty()); return blocks_.front().data[head_]; }
+        reference       back()        { MYSTL_DEBUG(!empty()); return blocks_.back().data[(head_ + size_ - 1) % buffer_size]; }
+        const_reference back()  const { MYSTL_DEBUG(!empty()); return blocks_.back().data[(head_ + size_ - 1) % buffer_size]; }
+
+        // 容量相关操作
+        bool      empty()           const noexcept { return size_ == 0; }
+        size_type size()            const noexcept { return size_; }
+        size_type memory_budget()   const noexcept { return budget_ * block_bytes; }
+        size_type resident_blocks() const noexcept { return resident_; }
+        size_type spilled_blocks()  const noexcept { return blocks_.size() - resident_; }
+
+        // 修改内存预算, 超出部分在之后的插入中逐步写出
+        void      set_memory_budget(size_type bytes) noexcept
+        {
+            budget_ = bytes / block_bytes < min_budget ? min_budget : bytes / block_bytes;
+        }
+
+        // 修改容器相关操作
+        template <class ...Args>
+        void      emplace_back(Args&& ...args);
+        template <class ...Args>
+        void      emplace_front(Args&& ...args);
+
+        void      push_back(const value_type &value)  { emplace_back(value); }
+        void      push_front(const value_type &value) { emplace_front(value); }
+
+        void      pop_front();
+        void      pop_back();
+        void      clear() noexcept;
+
+        void      swap(spill_deque &rhs) noexcept
+        {
+            blocks_.swap(rhs.blocks_);
+            mystl::swap(head_, rhs.head_);
+            mystl::swap(size_, rhs.size_);
+            mystl::swap(resident_, rhs.resident_);
+            mystl::swap(budget_, rhs.budget_);
+            mystl::swap(spare_, rhs.spare_);
+            mystl::swap(fd_, rhs.fd_);
+            mystl::swap(file_end_, rhs.file_end_);
+            free_offsets_.swap(rhs.free_offsets_);
+            dir_.swap(rhs.dir_);
+        }
+
+    private:
+        // helper functions
+        pointer   get_buffer();
+        void      put_buffer(pointer p) noexcept;
+        void      release_block(block &b) noexcept;
+
+        void      make_room();
+        void      spill(block &b);
+        void      page_in(block &b);
+        void      read_ahead() noexcept;
+        void      open_file();
+    };
+
+    /*****************************************************************************************/
+
+    template <class T, size_t BlockBytes>
+    template <class ...Args>
+    void spill_deque<T, BlockBytes>::emplace_back(Args&& ...args)
+    {
+        const size_type tail = head_ + size_;
+        if (tail == blocks_.size() * buffer_size) {
+            // 尾块已满, 追加新块
+            make_room();
+            block b = {get_buffer(), -1};
+            try {
+                blocks_.push_back(b);
+            }
+            catch (...) {
+                put_buffer(b.data);
+                throw;
+            }
+            ++resident_;
+        }
+        mystl::construct(blocks_.back().data + tail % buffer_size, mystl::forward<Args>(args)...);
+        ++size_;
+    }
+
+    template <class T, size_t BlockBytes>
+    template <class ...Args>
+    void spill_deque<T, BlockBytes>::emplace_front(Args&& ...args)
+    {
+        if (head_ == 0) {
+            // 头块已满, 在前面插入新块
+            make_room();
+            block b = {get_buffer(), -1};
+            try {
+                blocks_.push_front(b);
+            }
+            catch (...) {
+                put_buffer(b.data);
+                throw;
+            }
+            ++resident_;
+            head_ = buffer_size;
+        }
+        mystl::construct(blocks_.front().data + head_ - 1, mystl::forward<Args>(args)...);
+        --head_;
+        ++size_;
+    }
+
+    // 删空一块时先读回相邻的块再修改状态, 读回失败 (抛出异常) 时队列保持不变
+    template <class T, size_t BlockBytes>
+    void spill_deque<T, BlockBytes>::pop_front()
+    {
+        MYSTL_DEBUG(!empty());
+        if (size_ == 1) {
+            clear();
+            return;
+        }
+        if (head_ + 1 == buffer_size) {
+            if (blocks_[1].data == nullptr) {
+                make_room();
+                page_in(blocks_[1]);
+            }
+            release_block(blocks_.front());
+            blocks_.pop_front();
+            head_ = 0;
+            read_ahead();
+        }
+        else {
+            ++head_;
+        }
+        --size_;
+    }
+
+    template <class T, size_t BlockBytes>
+    void spill_deque<T, BlockBytes>::pop_back()
+    {
+        MYSTL_DEBUG(!empty());
+        if (size_ == 1) {
+            clear();
+            return;
+        }
+        if ((head_ + size_ - 1) % buffer_size == 0) {
+            block &prev = blocks_[blocks_.size() - 2];
+            if (prev.data == nullptr) {
+                make_room();
+                page_in(prev);
+            }
+            release_block(blocks_.back());
+            blocks_.pop_back();
+        }
+        --size_;
+    }
+
+    template <class T, size_t BlockBytes>
+    void spill_deque<T, BlockBytes>::clear() noexcept
+    {
+        while (!blocks_.empty()) {
+            release_block(blocks_.back());
+            blocks_.pop_back();
+        }
+        head_ = size_ = 0;
+        // 文件中已没有数据, 从头复用
+        free_offsets_.clear();
+        file_end_ = 0;
+    }
+
+    /*****************************************************************************************/
+    // helper function
+
+    template <class T, size_t BlockBytes>
+    typename spill_deque<T, BlockBytes>::pointer spill_deque<T, BlockBytes>::get_buffer()
+    {
+        if (spare_ != nullptr) {
+            pointer p = spare_;
+            spare_ = nullptr;
+            return p;
+        }
+        return data_allocator::allocate(buffer_size);
+    }
+
+    template <class T, size_t BlockBytes>
+    void spill_deque<T, BlockBytes>::put_buffer(pointer p) noexcept
+    {
+        if (spare_ == nullptr)
+            spare_ = p;
+        else
+            data_allocator::deallocate(p, buffer_size);
+    }
+
+    template <class T, size_t BlockBytes>
+    void spill_deque<T, BlockBytes>::release_block(block &b) noexcept
+    {
+        if (b.data != nullptr) {
+            put_buffer(b.data);
+            --resident_;
+        }
+        else {
+            try {
+                free_offsets_.push_back(b.offset);
+            }
+            catch (...) {
+                // 记不下的位置只是不再复用
+            }
+        }
+    }
+
+    // 常驻块数达到预算时, 把最靠近队尾的中间块写入文件 (队列按先进先出使用时, 它最晚被读到)
+    template <class T, size_t BlockBytes>
+    void spill_deque<T, BlockBytes>::make_room()
+    {
+        const size_type n = blocks_.size();
+        size_type i = n >= 2 ? n - 2 : 0;
+        while (resident_ >= budget_ && i >= 1) {
+            if (blocks_[i].data != nullptr)
+                spill(blocks_[i]);
+            --i;
+        }
+    }
+
+    template <class T, size_t BlockBytes>
+    void spill_deque<T, BlockBytes>::spill(block &b)
+    {
+        if (fd_ < 0)
+            open_file();
+        const bool reuse = !free_offsets_.empty();
+        const off_t offset = reuse ? free_offsets_.back() : file_end_;
+        const char *p = reinterpret_cast<const char*>(b.data);
+        size_type done = 0;
+        while (done < block_bytes) {
+            const ssize_t r = ::pwrite(fd_, p + done, block_bytes - done,
+                                       offset + static_cast<off_t>(done));
+            if (r < 0 && errno == EINTR)
+                continue;
+            THROW_RUNTIME_ERROR_IF(r <= 0, "spill_deque<T> failed to write the spill file");
+            done += static_cast<size_type>(r);
+        }
+        if (reuse)
+            free_offsets_.pop_back();
+        else
+            file_end_ += static_cast<off_t>(block_bytes);
+        put_buffer(b.data);
+        b.data = nullptr;
+        b.offset = offset;
+        --resident_;
+    }
+
+    template <class T, size_t BlockBytes>
+    void spill_deque<T, BlockBytes>::page_in(block &b)
+    {
+        pointer buf = get_buffer();
+        char *p = reinterpret_cast<char*>(buf);
+        size_type done = 0;
+        while (done < block_bytes) {
+            const ssize_t r = ::pread(fd_, p + done, block_bytes - done,
+                                      b.offset + static_cast<off_t>(done));
+            if (r < 0 && errno == EINTR)
+                continue;
+            if (r <= 0) {
+                put_buffer(buf);
+                THROW_RUNTIME_ERROR_IF(true, "spill_deque<T> failed to read the spill file");
+            }
+            done += static_cast<size_type>(r);
+        }
+        release_block(b);
+        b.data = buf;
+        b.offset = -1;
+        ++resident_;
+    }
+
+    // 提示内核预读队头之后已溢出的块, 等消费者到达时 pread 只需从页缓存复制
+    template <class T, size_t BlockBytes>
+    void spill_deque<T, BlockBytes>::read_ahead() noexcept
+    {
+#ifdef POSIX_FADV_WILLNEED
+        const size_type n = blocks_.size();
+        for (size_type i = 1; i < n && i <= SPILL_DEQUE_READ_AHEAD; ++i) {
+            if (blocks_[i].data == nullptr)
+                ::posix_fadvise(fd_, blocks_[i].offset, static_cast<off_t>(block_bytes),
+                                POSIX_FADV_WILLNEED);
+        }
+#endif
+    }
+
+    // 创建溢出文件后立即删除目录项, 进程退出时由系统回收
+    template <class T, size_t BlockBytes>
+    void spill_deque<T, BlockBytes>::open_file()
+    {
+        std::string path = dir_;
+        if (path.empty()) {
+            const char *env = ::getenv("TMPDIR");
+            path = env != nullptr && *env != '\0' ? env : "/tmp";
+        }
+        path += "/mystl_spill_XXXXXX";
+        const int fd = ::mkstemp(&path[0]);
+        THROW_RUNTIME_ERROR_IF(fd < 0, "spill_deque<T> failed to create the spill file");
+        ::unlink(path.c_str());
+        fd_ = fd;
+    }
+
+    // 重载 mystl 的 swap
+    template <class T, size_t BlockBytes>
+    void swap(spill_deque<T, BlockBytes> &lhs, spill_deque<T, BlockBytes> &rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+};
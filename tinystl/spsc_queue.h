@@ -0,0 +1,200 @@
+#pragma once
+
+/*
+ * 模板类 spsc_queue
+ * 单生产者单消费者的无锁环形队列, 容量固定且为 2 的幂.
+ * 生产者只写 tail_, 消费者只写 head_, 二者分处不同缓存行;
+ * 双方各自缓存对方的下标, 只有缓存值显示队列满/空时才去读对方的原子变量
+ */
+
+#include <atomic>
+#include <type_traits>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "construct.h"
+#include "exceptdef.h"
+#include "util.h"
+
+namespace mystl {
+    template <class T>
+    class spsc_queue {
+    public:
+        typedef T          value_type;
+        typedef T&         reference;
+        typedef const T&   const_reference;
+        typedef size_t     size_type;
+
+    private:
+        typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type slot_type;
+        typedef mystl::allocator<slot_type>                                slot_allocator;
+
+        slot_type  *slots_;
+        size_type   mask_;       // 容量 - 1
+
+        // 消费者一侧
+        alignas(MYSTL_CACHE_LINE_SIZE) std::atomic<size_type> head_;
+        size_type   tail_cache_; // 消费者看到的 tail_
+
+        // 生产者一侧
+        alignas(MYSTL_CACHE_LINE_SIZE) std::atomic<size_type> tail_;
+        size_type   head_cache_; // 生产者看到的 head_
+
+        char        pad_[MYSTL_CACHE_LINE_SIZE - sizeof(std::atomic<size_type>) - sizeof(size_type)];
+
+    public:
+        // 容量向上取整为 2 的幂
+        explicit spsc_queue(size_type capacity)
+            : slots_(nullptr), mask_(0), head_(0), tail_cache_(0), tail_(0), head_cache_(0)
+        {
+            THROW_LENGTH_ERROR_IF(capacity == 0 || capacity > (static_cast<size_type>(-1) >> 1) + 1,
+                                  "spsc_queue<T>'s capacity is invalid");
+            size_type cap = 1;
+            while (cap < capacity)
+                cap <<= 1;
+            slots_ = slot_allocator::allocate(cap);
+            mask_ = cap - 1;
+        }
+
+        spsc_queue(const spsc_queue&) = delete;
+        spsc_queue& operator=(const spsc_queue&) = delete;
+
+        ~spsc_queue()
+        {
+            const size_type t = tail_.load(std::memory_order_relaxed);
+            for (size_type h = head_.load(std::memory_order_relaxed); h != t; ++h)
+                mystl::destroy(slot(h));
+            slot_allocator::deallocate(slots_, mask_ + 1);
+        }
+
+    public:
+        // 容量相关操作, size/empty 只是某一时刻的近似值
+        size_type capacity() const noexcept { return mask_ + 1; }
+        size_type size() const noexcept
+        {
+            const size_type h = head_.load(std::memory_order_acquire);
+            return tail_.load(std::memory_order_acquire) - h;
+        }
+        bool      empty() const noexcept { return size() == 0; }
+
+        // 以下只能由生产者调用
+        template <class ...Args>
+        bool      try_emplace(Args&& ...args);
+        bool      try_push(const value_type &value) { return try_emplace(value); }
+        bool      try_push(value_type &&value)      { return try_emplace(mystl::move(value)); }
+
+        // 最多放入 n 个元素, 返回实际放入的个数, 只发布一次 tail_
+        template <class IIter>
+        size_type try_push_n(IIter first, size_type n);
+
+        // 以下只能由消费者调用
+        bool      try_pop(value_type &out);
+
+        // 最多取出 n 个元素写入 result, 返回实际取出的个数, 只发布一次 head_
+        template <class OIter>
+        size_type try_pop_n(OIter result, size_type n);
+
+    private:
+        T*        slot(size_type i) const noexcept { return reinterpret_cast<T*>(slots_ + (i & mask_)); }
+
+        size_type free_slots(size_type t, size_type want) noexcept;
+        size_type ready_slots(size_type h, size_type want) noexcept;
+    };
+
+    /*****************************************************************************************/
+
+    template <class T>
+    template <class ...Args>
+    bool spsc_queue<T>::try_emplace(Args&& ...args)
+    {
+        const size_type t = tail_.load(std::memory_order_relaxed);
+        if (free_slots(t, 1) == 0)
+            return false;
+        mystl::construct(slot(t), mystl::forward<Args>(args)...);
+        tail_.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <class T>
+    template <class IIter>
+    typename spsc_queue<T>::size_type spsc_queue<T>::try_push_n(IIter first, size_type n)
+    {
+        const size_type t = tail_.load(std::memory_order_relaxed);
+        const size_type m = free_slots(t, n);
+        size_type i = 0;
+        try {
+            for (; i < m; ++i, ++first)
+                mystl::construct(slot(t + i), *first);
+        }
+        catch (...) {
+            // 已构造的元素照常发布
+            tail_.store(t + i, std::memory_order_release);
+            throw;
+        }
+        tail_.store(t + m, std::memory_order_release);
+        return m;
+    }
+
+    template <class T>
+    bool spsc_queue<T>::try_pop(value_type &out)
+    {
+        const size_type h = head_.load(std::memory_order_relaxed);
+        if (ready_slots(h, 1) == 0)
+            return false;
+        T *p = slot(h);
+        out = mystl::move(*p);
+        mystl::destroy(p);
+        head_.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <class T>
+    template <class OIter>
+    typename spsc_queue<T>::size_type spsc_queue<T>::try_pop_n(OIter result, size_type n)
+    {
+        const size_type h = head_.load(std::memory_order_relaxed);
+        const size_type m = ready_slots(h, n);
+        size_type i = 0;
+        try {
+            for (; i < m; ++i, ++result) {
+                T *p = slot(h + i);
+                *result = mystl::move(*p);
+                mystl::destroy(p);
+            }
+        }
+        catch (...) {
+            // 写出失败的元素仍留在队列中
+            head_.store(h + i, std::memory_order_release);
+            throw;
+        }
+        head_.store(h + m, std::memory_order_release);
+        return m;
+    }
+
+    /*****************************************************************************************/
+    // helper function
+
+    // 生产者可写的槽位数, 不超过 want; 缓存值不够时才重新读取 head_
+    template <class T>
+    typename spsc_queue<T>::size_type spsc_queue<T>::free_slots(size_type t, size_type want) noexcept
+    {
+        size_type n = mask_ + 1 - (t - head_cache_);
+        if (n < want) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            n = mask_ + 1 - (t - head_cache_);
+        }
+        return n < want ? n : want;
+    }
+
+    // 消费者可读的元素数, 不超过 want; 缓存值不够时才重新读取 tail_
+    template <class T>
+    typename spsc_queue<T>::size_type spsc_queue<T>::ready_slots(size_type h, size_type want) noexcept
+    {
+        size_type n = tail_cache_ - h;
+        if (n < want) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            n = tail_cache_ - h;
+        }
+        return n < want ? n : want;
+    }
+};
@@ -0,0 +1,270 @@
+#pragma once
+
+/*
+ * 类 thread_pool
+ * 工作窃取线程池: 每个工作线程拥有一个 work_stealing_deque, 自己产生的任务压入自己的队列底部,
+ * 空闲时先取外部提交队列, 再从随机选取的其它工作线程的队列顶部窃取.
+ * parallel_for 把区间对半拆分, 右半作为任务交出, 左半继续拆分, 大块任务因而先被窃取
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "allocator.h"
+#include "concurrent_queue.h"
+#include "construct.h"
+#include "util.h"
+#include "work_stealing_deque.h"
+
+#ifndef THREAD_POOL_SPIN_COUNT
+#define THREAD_POOL_SPIN_COUNT 64
+#endif
+
+namespace mystl {
+    class thread_pool {
+    public:
+        typedef size_t size_type;
+
+    private:
+        struct task {
+            std::function<void()> fn;
+        };
+
+        struct worker {
+            work_stealing_deque<task*> tasks;
+            std::thread                thread;
+        };
+
+        // 当前线程所属的线程池及其编号
+        struct worker_id {
+            thread_pool *pool;
+            size_type    index;
+        };
+
+        typedef mystl::allocator<worker> worker_allocator;
+
+        worker                       *workers_;
+        size_type                     count_;
+        concurrent_queue<task*>       inject_;    // 非工作线程提交的任务
+        std::atomic<size_type>        pending_;   // 已提交但尚未被取走的任务数
+        std::atomic<size_type>        sleepers_;
+        std::atomic<bool>             stop_;
+        std::mutex                    mutex_;
+        std::condition_variable       wake_;
+
+    public:
+        explicit thread_pool(size_type n = std::thread::hardware_concurrency())
+            : workers_(nullptr), count_(0), pending_(0), sleepers_(0), stop_(false)
+        {
+            if (n == 0)
+                n = 1;
+            workers_ = worker_allocator::allocate(n);
+            for (size_type i = 0; i < n; ++i)
+                mystl::construct(workers_ + i);
+            count_ = n;
+            size_type i = 0;
+            try {
+                for (; i < n; ++i)
+                    workers_[i].thread = std::thread(&thread_pool::run, this, i);
+            }
+            catch (...) {
+                shutdown(i);
+                throw;
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        // 等待所有已提交的任务执行完毕
+        ~thread_pool()
+        {
+            shutdown(count_);
+        }
+
+    public:
+        size_type size() const noexcept { return count_; }
+
+        // 提交一个任务, 任务不应抛出异常
+        template <class F>
+        void submit(F &&f)
+        {
+            task *t = new task{std::function<void()>(mystl::forward<F>(f))};
+            pending_.fetch_add(1);
+            worker_id &id = current();
+            try {
+                if (id.pool == this)
+                    workers_[id.index].tasks.push(t);
+                else
+                    inject_.push(t);
+            }
+            catch (...) {
+                // 队列扩容失败, 任务未被放入, 撤销计数以免析构函数一直等待
+                pending_.fetch_sub(1);
+                delete t;
+                throw;
+            }
+            if (sleepers_.load() != 0) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                wake_.notify_one();
+            }
+        }
+
+        // 对 [first, last) 中的每个下标 i 调用 f(i), 返回时全部完成.
+        // grain 为不再拆分的区间长度, 为 0 时按线程数自动选取. f 抛出的第一个异常在此重新抛出
+        template <class Index, class F>
+        void parallel_for(Index first, Index last, F f, size_type grain = 0)
+        {
+            if (!(first < last))
+                return;
+            const size_type n = static_cast<size_type>(last - first);
+            if (grain == 0)
+                grain = n / (count_ * 8) > 0 ? n / (count_ * 8) : 1;
+            for_state<F> state(f, grain);
+            for_range(&state, first, last);
+            // 等待期间帮忙执行任务, 工作线程中嵌套调用也不会死锁
+            while (state.pending.load(std::memory_order_acquire) != 0) {
+                if (!help())
+                    std::this_thread::yield();
+            }
+            if (state.error)
+                std::rethrow_exception(state.error);
+        }
+
+    private:
+        template <class F>
+        struct for_state {
+            F                      &f;
+            size_type               grain;
+            std::atomic<size_type>  pending;
+            std::exception_ptr      error;
+            std::mutex              error_mutex;
+
+            for_state(F &fn, size_type g) : f(fn), grain(g), pending(1) {}
+        };
+
+        template <class Index, class F>
+        void for_range(for_state<F> *s, Index lo, Index hi)
+        {
+            while (static_cast<size_type>(hi - lo) > s->grain) {
+                const Index mid = lo + (hi - lo) / 2;
+                s->pending.fetch_add(1);
+                try {
+                    submit([this, s, mid, hi] { for_range(s, mid, hi); });
+                }
+                catch (...) {
+                    // 无法交出任务时自己完成整个区间
+                    s->pending.fetch_sub(1);
+                    break;
+                }
+                hi = mid;
+            }
+            try {
+                for (; lo < hi; ++lo)
+                    s->f(lo);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(s->error_mutex);
+                if (!s->error)
+                    s->error = std::current_exception();
+            }
+            s->pending.fetch_sub(1, std::memory_order_release);
+        }
+
+        static worker_id& current() noexcept
+        {
+            static thread_local worker_id id = {nullptr, 0};
+            return id;
+        }
+
+        // 依次尝试自己的队列、外部提交队列、随机选取的其它工作线程
+        bool find_task(size_type self, unsigned &seed, task *&t) noexcept
+        {
+            if (self < count_ && workers_[self].tasks.pop(t))
+                return true;
+            if (inject_.try_pop(t))
+                return true;
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            const size_type start = seed % count_;
+            for (size_type k = 0; k < count_; ++k) {
+                const size_type victim = (start + k) % count_;
+                if (victim != self && workers_[victim].tasks.steal(t))
+                    return true;
+            }
+            return false;
+        }
+
+        void execute(task *t) noexcept
+        {
+            pending_.fetch_sub(1);
+            t->fn();
+            delete t;
+        }
+
+        // 在当前线程中执行一个任务, 没有可执行的任务时返回 false
+        bool help()
+        {
+            static thread_local unsigned seed = 0x9E3779B9u;
+            worker_id &id = current();
+            const size_type self = id.pool == this ? id.index : count_;
+            task *t = nullptr;
+            if (!find_task(self, seed, t))
+                return false;
+            execute(t);
+            return true;
+        }
+
+        void run(size_type self)
+        {
+            current().pool = this;
+            current().index = self;
+            unsigned seed = static_cast<unsigned>(self) * 2654435761u + 1;
+            size_type idle = 0;
+            for (;;) {
+                task *t = nullptr;
+                if (find_task(self, seed, t)) {
+                    execute(t);
+                    idle = 0;
+                    continue;
+                }
+                if (stop_.load() && pending_.load() == 0)
+                    return;
+                // 先短暂自旋, 仍无任务才睡眠
+                if (++idle < THREAD_POOL_SPIN_COUNT) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                idle = 0;
+                std::unique_lock<std::mutex> lock(mutex_);
+                sleepers_.fetch_add(1);
+                while (pending_.load() == 0 && !stop_.load())
+                    wake_.wait(lock);
+                sleepers_.fetch_sub(1);
+            }
+        }
+
+        // 通知前 n 个已启动的工作线程退出并等待它们结束
+        void shutdown(size_type n) noexcept
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_.store(true);
+                wake_.notify_all();
+            }
+            for (size_type i = 0; i < n; ++i) {
+                if (workers_[i].thread.joinable())
+                    workers_[i].thread.join();
+            }
+            for (size_type i = 0; i < count_; ++i)
+                mystl::destroy(workers_ + i);
+            worker_allocator::deallocate(workers_, count_);
+            workers_ = nullptr;
+        }
+    };
+};
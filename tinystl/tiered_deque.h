@@ -0,0 +1,679 @@
+#pragma once
+
+/*
+ * 模板类 tiered_deque
+ * 分层 (平方分解) 的序列: 与 deque 一样用一组定长缓冲区保存元素, 但每个缓冲区自身是环形缓冲区.
+ * 除首尾两块外所有缓冲区都是满的, 第 i 个元素所在的块与位置可以直接算出, 随机访问 O(1);
+ * 在中间插入、删除时, 只在目标块内移动 O(B) 个元素, 其余的满块只需旋转环形缓冲区的起点,
+ * 每块 O(1), 总代价 O(B + n / B). 元素个数变化时重建, 保持 B 约为 sqrt(n)
+ */
+
+#include <initializer_list>
+
+#include "allocator.h"
+#include "construct.h"
+#include "deque.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "util.h"
+
+namespace mystl {
+    // 缓冲区大小的最小值为 2^TIERED_DEQUE_MIN_SHIFT
+    #ifndef TIERED_DEQUE_MIN_SHIFT
+    #define TIERED_DEQUE_MIN_SHIFT 6
+    #endif
+
+    template <class T>
+    class tiered_deque;
+
+    // tiered_deque 的迭代器: 以容器指针 + 下标表示, 随机访问
+    template <class T, class Ref, class Ptr>
+    struct tiered_deque_iterator : public iterator<random_access_iterator_tag, T> {
+        typedef tiered_deque_iterator<T, T&, T*>              iterator;
+        typedef tiered_deque_iterator<T, const T&, const T*>  const_iterator;
+        typedef tiered_deque_iterator                         self;
+
+        typedef T          value_type;
+        typedef Ptr        pointer;
+        typedef Ref        reference;
+        typedef size_t     size_type;
+        typedef ptrdiff_t  difference_type;
+
+        typedef typename std::conditional<std::is_const<typename std::remove_reference<Ref>::type>::value,
+            const tiered_deque<T>*, tiered_deque<T>*>::type container_pointer;
+
+        container_pointer c;     // 所属容器
+        size_type         index; // 元素下标
+
+        tiered_deque_iterator() noexcept : c(nullptr), index(0) {}
+        tiered_deque_iterator(container_pointer x, size_type i) noexcept : c(x), index(i) {}
+        tiered_deque_iterator(const iterator &rhs) noexcept : c(rhs.c), index(rhs.index) {}
+
+        self& operator=(const iterator &rhs) noexcept
+        {
+            c = rhs.c;
+            index = rhs.index;
+            return *this;
+        }
+
+        reference operator*()  const { return (*c)[index]; }
+        pointer   operator->() const { return &(operator*()); }
+
+        difference_type operator-(const self &x) const
+        {
+            return static_cast<difference_type>(index) - static_cast<difference_type>(x.index);
+        }
+
+        self& operator++() { ++index; return *this; }
+        self  operator++(int)
+        {
+            self tmp = *this;
+            ++index;
+            return tmp;
+        }
+        self& operator--() { --index; return *this; }
+        self  operator--(int)
+        {
+            self tmp = *this;
+            --index;
+            return tmp;
+        }
+
+        self& operator+=(difference_type n) { index += n; return *this; }
+        self  operator+(difference_type n) const
+        {
+            self tmp = *this;
+            return tmp += n;
+        }
+        self& operator-=(difference_type n) { return *this += -n; }
+        self  operator-(difference_type n) const
+        {
+            self tmp = *this;
+            return tmp -= n;
+        }
+
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        bool operator==(const self &rhs) const { return index == rhs.index; }
+        bool operator!=(const self &rhs) const { return index != rhs.index; }
+        bool operator< (const self &rhs) const { return index < rhs.index; }
+        bool operator> (const self &rhs) const { return rhs < *this; }
+        bool operator<=(const self &rhs) const { return !(rhs < *this); }
+        bool operator>=(const self &rhs) const { return !(*this < rhs); }
+    };
+
+    // 模板类 tiered_deque
+    template <class T>
+    class tiered_deque {
+    public:
+        typedef mystl::allocator<T>                      allocator_type;
+        typedef mystl::allocator<T>                      data_allocator;
+
+        typedef T                                        value_type;
+        typedef T*                                       pointer;
+        typedef const T*                                 const_pointer;
+        typedef T&                                       reference;
+        typedef const T&                                 const_reference;
+        typedef size_t                                   size_type;
+        typedef ptrdiff_t                                difference_type;
+
+        typedef tiered_deque_iterator<T, T&, T*>             iterator;
+        typedef tiered_deque_iterator<T, const T&, const T*> const_iterator;
+        typedef mystl::reverse_iterator<iterator>        reverse_iterator;
+        typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+    private:
+        // 每个缓冲区是容量为 2^shift_ 的环形缓冲区, 逻辑位置 p 存放在 data[(head + p) & mask]
+        struct block {
+            pointer   data;
+            size_type head;
+        };
+
+        // 第一个元素位于第 0 块的逻辑位置 gap_, 第 i 个元素的偏移为 gap_ + i
+        mystl::deque<block> blocks_;
+        size_type           shift_;
+        size_type           gap_;
+        size_type           size_;
+        size_type           failed_;  // 上次重建失败时的元素个数, 0 表示没有失败
+
+    public:
+        // 构造、复制、移动、析构函数
+        tiered_deque() noexcept
+            : blocks_(), shift_(TIERED_DEQUE_MIN_SHIFT), gap_(0), size_(0), failed_(0)
+        {
+        }
+
+        template <class IIter, typename std::enable_if<
+            mystl::is_input_iterator<IIter>::value, int>::type = 0>
+        tiered_deque(IIter first, IIter last)
+            : tiered_deque()
+        {
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+
+        tiered_deque(std::initializer_list<value_type> ilist)
+            : tiered_deque(ilist.begin(), ilist.end())
+        {
+        }
+
+        tiered_deque(const tiered_deque &rhs)
+            : tiered_deque()
+        {
+            for (size_type i = 0; i < rhs.size_; ++i)
+                emplace_back(rhs[i]);
+        }
+
+        tiered_deque(tiered_deque &&rhs) noexcept
+            : blocks_(mystl::move(rhs.blocks_)), shift_(rhs.shift_), gap_(rhs.gap_), size_(rhs.size_),
+              failed_(rhs.failed_)
+        {
+            rhs.shift_ = TIERED_DEQUE_MIN_SHIFT;
+            rhs.gap_ = 0;
+            rhs.size_ = 0;
+            rhs.failed_ = 0;
+        }
+
+        tiered_deque& operator=(const tiered_deque &rhs)
+        {
+            if (this != &rhs) {
+                tiered_deque tmp(rhs);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        tiered_deque& operator=(tiered_deque &&rhs) noexcept
+        {
+            if (this != &rhs) {
+                tiered_deque tmp(mystl::move(rhs));
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        ~tiered_deque()
+        {
+            clear();
+        }
+
+    public:
+        // 迭代器相关操作
+        iterator               begin()         noexcept { return iterator(this, 0); }
+        const_iterator         begin()   const noexcept { return const_iterator(this, 0); }
+        iterator               end()           noexcept { return iterator(this, size_); }
+        const_iterator         end()     const noexcept { return const_iterator(this, size_); }
+
+        reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+        const_iterator         cbegin()  const noexcept { return begin(); }
+        const_iterator         cend()    const noexcept { return end(); }
+
+        // 容量相关操作
+        bool      empty()      const noexcept { return size_ == 0; }
+        size_type size()       const noexcept { return size_; }
+        size_type block_size() const noexcept { return size_type(1) << shift_; }
+
+        // 访问元素相关操作
+        reference       operator[](size_type n)
+        {
+            MYSTL_DEBUG(n < size_);
+            return at_offset(gap_ + n);
+        }
+        const_reference operator[](size_type n) const
+        {
+            MYSTL_DEBUG(n < size_);
+            return at_offset(gap_ + n);
+        }
+
+        reference       at(size_type n)
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size_), "tiered_deque<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+        const_reference at(size_type n) const
+        {
+            THROW_OUT_OF_RANGE_IF(!(n < size_), "tiered_deque<T>::at() subscript out of range");
+            return (*this)[n];
+        }
+
+        reference       front()       { MYSTL_DEBUG(!empty()); return (*this)[0]; }
+        const_reference front() const { MYSTL_DEBUG(!empty()); return (*this)[0]; }
+        reference       back()        { MYSTL_DEBUG(!empty()); return (*this)[size_ - 1]; }
+        const_reference back()  const { MYSTL_DEBUG(!empty()); return (*this)[size_ - 1]; }
+
+        // 修改容器相关操作
+        template <class ...Args>
+        void        emplace_back(Args&& ...args);
+        template <class ...Args>
+        void        emplace_front(Args&& ...args);
+        template <class ...Args>
+        iterator    emplace(iterator pos, Args&& ...args);
+
+        void        push_back(const value_type &value)  { emplace_back(value); }
+        void        push_back(value_type &&value)       { emplace_back(mystl::move(value)); }
+        void        push_front(const value_type &value) { emplace_front(value); }
+        void        push_front(value_type &&value)      { emplace_front(mystl::move(value)); }
+
+        iterator    insert(iterator pos, const value_type &value) { return emplace(pos, value); }
+        iterator    insert(iterator pos, value_type &&value)
+        { return emplace(pos, mystl::move(value)); }
+
+        void        pop_back();
+        void        pop_front();
+        iterator    erase(iterator pos);
+        void        clear();
+
+        void        swap(tiered_deque &rhs) noexcept
+        {
+            blocks_.swap(rhs.blocks_);
+            mystl::swap(shift_, rhs.shift_);
+            mystl::swap(gap_, rhs.gap_);
+            mystl::swap(size_, rhs.size_);
+            mystl::swap(failed_, rhs.failed_);
+        }
+
+    private:
+        // helper functions
+        size_type   mask() const noexcept { return block_size() - 1; }
+
+        reference   slot(size_type b, size_type p) noexcept
+        {
+            const block &blk = blocks_[b];
+            return blk.data[(blk.head + p) & mask()];
+        }
+        const_reference slot(size_type b, size_type p) const noexcept
+        {
+            const block &blk = blocks_[b];
+            return blk.data[(blk.head + p) & mask()];
+        }
+        reference   at_offset(size_type off) noexcept { return slot(off >> shift_, off & mask()); }
+        const_reference at_offset(size_type off) const noexcept
+        { return slot(off >> shift_, off & mask()); }
+
+        // 旋转环形缓冲区: 逻辑位置整体后移 / 前移一位
+        void        rotate_right(size_type b) noexcept
+        { blocks_[b].head = (blocks_[b].head - 1) & mask(); }
+        void        rotate_left(size_type b) noexcept
+        { blocks_[b].head = (blocks_[b].head + 1) & mask(); }
+
+        // dst 未构造时构造, 否则赋值
+        static void put(T &dst, T &&src, bool &raw)
+        {
+            if (raw)
+                mystl::construct(&dst, mystl::move(src));
+            else
+                dst = mystl::move(src);
+            raw = false;
+        }
+
+        block       new_block()
+        {
+            block blk;
+            blk.data = data_allocator::allocate(block_size());
+            blk.head = 0;
+            return blk;
+        }
+        void        free_block(const block &blk) noexcept
+        {
+            data_allocator::deallocate(blk.data, block_size());
+        }
+
+        // 在两端加入一块新缓冲区, 加入失败时释放它
+        void        append_block()
+        {
+            block blk = new_block();
+            try {
+                blocks_.push_back(blk);
+            }
+            catch (...) {
+                free_block(blk);
+                throw;
+            }
+        }
+        void        prepend_block()
+        {
+            block blk = new_block();
+            try {
+                blocks_.push_front(blk);
+            }
+            catch (...) {
+                free_block(blk);
+                throw;
+            }
+        }
+
+        void        insert_right(size_type index, value_type &&value);
+        void        insert_left(size_type index, value_type &&value);
+        void        erase_right(size_type index);
+        void        erase_left(size_type index);
+
+        void        rebalance();
+        void        rebuild(size_type new_shift);
+    };
+
+    /*****************************************************************************************/
+
+    // 在尾部构建元素
+    template <class T>
+    template <class ...Args>
+    void tiered_deque<T>::emplace_back(Args&& ...args)
+    {
+        const size_type end_off = gap_ + size_;
+        if (end_off == (blocks_.size() << shift_)) {
+            append_block();
+            try {
+                mystl::construct(&at_offset(end_off), mystl::forward<Args>(args)...);
+            }
+            catch (...) {
+                free_block(blocks_.back());
+                blocks_.pop_back();
+                throw;
+            }
+        }
+        else {
+            mystl::construct(&at_offset(end_off), mystl::forward<Args>(args)...);
+        }
+        ++size_;
+        rebalance();
+    }
+
+    // 在头部构建元素
+    template <class T>
+    template <class ...Args>
+    void tiered_deque<T>::emplace_front(Args&& ...args)
+    {
+        if (gap_ == 0) {
+            prepend_block();
+            try {
+                mystl::construct(&slot(0, mask()), mystl::forward<Args>(args)...);
+            }
+            catch (...) {
+                free_block(blocks_.front());
+                blocks_.pop_front();
+                throw;
+            }
+            gap_ = mask();
+        }
+        else {
+            mystl::construct(&slot(0, gap_ - 1), mystl::forward<Args>(args)...);
+            --gap_;
+        }
+        ++size_;
+        rebalance();
+    }
+
+    // 在 pos 前构建元素, 移动较短的一侧
+    template <class T>
+    template <class ...Args>
+    typename tiered_deque<T>::iterator tiered_deque<T>::emplace(iterator pos, Args&& ...args)
+    {
+        const size_type index = pos.index;
+        MYSTL_DEBUG(index <= size_);
+        if (index == size_) {
+            emplace_back(mystl::forward<Args>(args)...);
+        }
+        else if (index == 0) {
+            emplace_front(mystl::forward<Args>(args)...);
+        }
+        else {
+            value_type value(mystl::forward<Args>(args)...);
+            if (index < size_ / 2)
+                insert_left(index, mystl::move(value));
+            else
+                insert_right(index, mystl::move(value));
+            ++size_;
+            rebalance();
+        }
+        return iterator(this, index);
+    }
+
+    // 取出尾部元素, 最后一块为空时释放
+    template <class T>
+    void tiered_deque<T>::pop_back()
+    {
+        MYSTL_DEBUG(!empty());
+        mystl::destroy(&at_offset(gap_ + size_ - 1));
+        --size_;
+        if (size_ == 0) {
+            clear();
+            return;
+        }
+        if (gap_ + size_ <= ((blocks_.size() - 1) << shift_)) {
+            free_block(blocks_.back());
+            blocks_.pop_back();
+        }
+        rebalance();
+    }
+
+    // 取出头部元素, 第一块为空时释放
+    template <class T>
+    void tiered_deque<T>::pop_front()
+    {
+        MYSTL_DEBUG(!empty());
+        mystl::destroy(&slot(0, gap_));
+        --size_;
+        if (size_ == 0) {
+            clear();
+            return;
+        }
+        if (++gap_ == block_size()) {
+            free_block(blocks_.front());
+            blocks_.pop_front();
+            gap_ = 0;
+        }
+        rebalance();
+    }
+
+    // 删除 pos 处的元素, 移动较短的一侧
+    template <class T>
+    typename tiered_deque<T>::iterator tiered_deque<T>::erase(iterator pos)
+    {
+        const size_type index = pos.index;
+        MYSTL_DEBUG(index < size_);
+        if (index == 0) {
+            pop_front();
+        }
+        else if (index == size_ - 1) {
+            pop_back();
+        }
+        else {
+            if (index < size_ / 2)
+                erase_left(index);
+            else
+                erase_right(index);
+            rebalance();
+        }
+        return iterator(this, index);
+    }
+
+    template <class T>
+    void tiered_deque<T>::clear()
+    {
+        for (size_type i = 0; i < size_; ++i)
+            mystl::destroy(&at_offset(gap_ + i));
+        for (size_type b = 0; b < blocks_.size(); ++b)
+            free_block(blocks_[b]);
+        blocks_.clear();
+        gap_ = 0;
+        size_ = 0;
+        failed_ = 0;
+    }
+
+    /*****************************************************************************************/
+    // helper function
+
+    // [index, size_) 整体后移一位: 末尾之后的空位从最后一块逐块向前传递,
+    // 经过的满块只旋转起点, 只有 index 所在的块逐个移动元素
+    template <class T>
+    void tiered_deque<T>::insert_right(size_type index, value_type &&value)
+    {
+        const size_type end_off = gap_ + size_;
+        if (end_off == (blocks_.size() << shift_))
+            append_block();
+        const size_type last = end_off >> shift_;  // 空位所在的块
+        const size_type off = gap_ + index;
+        const size_type bt = off >> shift_;
+        const size_type pt = off & mask();
+
+        bool raw = true;  // 空位是否尚未构造
+        size_type hole = end_off & mask();
+        for (size_type b = last; b > bt; --b) {
+            // 该块的逻辑末位为空位, 旋转后空位到达逻辑首位, 再由前一块的末元素填入
+            rotate_right(b);
+            put(slot(b, 0), mystl::move(slot(b - 1, mask())), raw);
+            hole = mask();
+        }
+        for (; hole > pt; --hole)
+            put(slot(bt, hole), mystl::move(slot(bt, hole - 1)), raw);
+        put(slot(bt, pt), mystl::move(value), raw);
+    }
+
+    // [0, index) 整体前移一位, 与 insert_right 对称
+    template <class T>
+    void tiered_deque<T>::insert_left(size_type index, value_type &&value)
+    {
+        if (gap_ == 0) {
+            prepend_block();
+            gap_ = block_size();
+        }
+        const size_type off = gap_ + index - 1;  // 新元素的偏移
+        const size_type bt = off >> shift_;
+        const size_type pt = off & mask();
+
+        bool raw = true;
+        size_type hole = gap_ - 1;
+        for (size_type b = 0; b < bt; ++b) {
+            // 该块的逻辑首位为空位, 旋转后空位到达逻辑末位, 再由后一块的首元素填入
+            rotate_left(b);
+            put(slot(b, mask()), mystl::move(slot(b + 1, 0)), raw);
+            hole = 0;
+        }
+        for (; hole < pt; ++hole)
+            put(slot(bt, hole), mystl::move(slot(bt, hole + 1)), raw);
+        put(slot(bt, pt), mystl::move(value), raw);
+        --gap_;
+    }
+
+    // 删除第 index 个元素, 之后的元素整体前移一位
+    template <class T>
+    void tiered_deque<T>::erase_right(size_type index)
+    {
+        const size_type last_off = gap_ + size_ - 1;
+        const size_type last = last_off >> shift_;
+        const size_type off = gap_ + index;
+        const size_type b = off >> shift_;
+
+        const size_type block_last = b == last ? (last_off & mask()) : mask();
+        for (size_type p = off & mask(); p < block_last; ++p)
+            slot(b, p) = mystl::move(slot(b, p + 1));
+        for (size_type j = b + 1; j <= last; ++j) {
+            slot(j - 1, mask()) = mystl::move(slot(j, 0));
+            rotate_left(j);  // 移走的首位旋转到逻辑末位
+        }
+        // 最后一个已构造的位置
+        if (b == last)
+            mystl::destroy(&slot(last, block_last));
+        else
+            mystl::destroy(&slot(last, mask()));
+        --size_;
+        if (gap_ + size_ <= (last << shift_)) {
+            free_block(blocks_.back());
+            blocks_.pop_back();
+        }
+    }
+
+    // 删除第 index 个元素, 之前的元素整体后移一位
+    template <class T>
+    void tiered_deque<T>::erase_left(size_type index)
+    {
+        const size_type off = gap_ + index;
+        const size_type b = off >> shift_;
+
+        const size_type block_first = b == 0 ? gap_ : 0;
+        for (size_type p = off & mask(); p > block_first; --p)
+            slot(b, p) = mystl::move(slot(b, p - 1));
+        if (b != 0) {
+            for (size_type j = b - 1; j > 0; --j) {
+                slot(j + 1, 0) = mystl::move(slot(j, mask()));
+                rotate_right(j);  // 移走的末位旋转到逻辑首位
+            }
+            // 第 0 块前面是未构造的空位, 不能旋转, 逐个后移
+            slot(1, 0) = mystl::move(slot(0, mask()));
+            for (size_type p = mask(); p > gap_; --p)
+                slot(0, p) = mystl::move(slot(0, p - 1));
+        }
+        mystl::destroy(&slot(0, gap_));
+        --size_;
+        if (++gap_ == block_size()) {
+            free_block(blocks_.front());
+            blocks_.pop_front();
+            gap_ = 0;
+        }
+    }
+
+    // 元素个数超过 4B^2 时加倍 B, 不足 B^2/16 时减半, 使 B 保持在 sqrt(n) 附近.
+    // 调用时插入或删除已经完成, 重建失败不影响容器的内容, 只是暂时保持原来的 B.
+    // 失败后元素个数变化不到一倍时不再重试, 避免每次插入、删除都付出 O(n) 的代价
+    template <class T>
+    void tiered_deque<T>::rebalance()
+    {
+        if (failed_ != 0 && size_ < failed_ * 2 && size_ * 2 > failed_)
+            return;
+        const size_type bs = block_size();
+        try {
+            if (size_ / 4 > bs * bs) {
+                rebuild(shift_ + 1);
+            }
+            else if (shift_ > TIERED_DEQUE_MIN_SHIFT && size_ * 16 < bs * bs) {
+                rebuild(shift_ - 1);
+            }
+            failed_ = 0;
+        }
+        catch (...) {
+            failed_ = size_;
+        }
+    }
+
+    // 移动构造可能抛出异常时改为复制, 重建失败时 *this 不变
+    template <class T>
+    void tiered_deque<T>::rebuild(size_type new_shift)
+    {
+        tiered_deque tmp;
+        tmp.shift_ = new_shift;
+        const size_type n = size_;
+        for (size_type i = 0; i < n; ++i) {
+            // 直接追加, 重建过程中不再触发 rebalance
+            const size_type end_off = tmp.gap_ + tmp.size_;
+            if (end_off == (tmp.blocks_.size() << tmp.shift_))
+                tmp.append_block();
+            mystl::construct(&tmp.at_offset(end_off), mystl::move_if_noexcept((*this)[i]));
+            ++tmp.size_;
+        }
+        swap(tmp);
+    }
+
+    // 重载比较操作符
+    template <class T>
+    bool operator==(const tiered_deque<T> &lhs, const tiered_deque<T> &rhs)
+    {
+        return lhs.size() == rhs.size() &&
+            mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T>
+    bool operator!=(const tiered_deque<T> &lhs, const tiered_deque<T> &rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    // 重载 mystl 的 swap
+    template <class T>
+    void swap(tiered_deque<T> &lhs, tiered_deque<T> &rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+};
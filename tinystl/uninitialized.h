@@ -39,6 +39,23 @@ namespace mystl {
         return unchecked_copy_n(first, n, result, iterator_category(first));
     }
 
+    /*
+     * __is_uninit_copyable / __is_uninit_movable
+     * 可以直接对未初始化空间赋值的型别: 既要可以按位复制, 赋值运算符也要是平凡且未被删除的,
+     * 例如含 const 成员的结构体虽然 trivially copyable, 但不能赋值, 只能逐个构造
+     */
+    template <class T>
+    struct __is_uninit_copyable
+        : public std::integral_constant<bool,
+            std::is_trivially_copyable<T>::value &&
+            std::is_trivially_copy_assignable<T>::value> {};
+
+    template <class T>
+    struct __is_uninit_movable
+        : public std::integral_constant<bool,
+            std::is_trivially_copyable<T>::value &&
+            std::is_trivially_move_assignable<T>::value> {};
+
     /*
      * uninitialized_copy
      * 复制 [first, last) 上到 result 起始的位置
@@ -62,6 +79,7 @@ namespace mystl {
             for (; result != cur; ++result) {
                 mystl::destroy(&*result);
             }
+            throw;
         }
 
         return cur;
@@ -71,7 +89,7 @@ namespace mystl {
     ForwardIter uninitialized_copy(InputIter first, InputIter last, ForwardIter result)
     {
         return mystl::__uninitialized_copy(first, last, result,
-                                            std::is_trivially_copy_assignable<
+                                            mystl::__is_uninit_copyable<
                                             typename iterator_traits<ForwardIter>::
                                             value_type>{});
     }
@@ -101,6 +119,7 @@ namespace mystl {
         {
             for (; result != cur; ++result)
             mystl::destroy(&*result);
+            throw;
         }
         return cur;
     }
@@ -109,7 +128,7 @@ namespace mystl {
     ForwardIter uninitialized_copy_n(InputIter first, Size n, ForwardIter result)
     {
         return mystl::unchecked_uninit_copy_n(first, n, result,
-                                             std::is_trivially_copy_assignable<
+                                             mystl::__is_uninit_copyable<
                                              typename iterator_traits<InputIter>::
                                              value_type>{});
     }
@@ -136,6 +155,7 @@ namespace mystl {
         catch (...) {
             for (; first != cur; ++first) 
                 mystl::destroy(&*first);
+            throw;
         }
     }
 
@@ -143,7 +163,7 @@ namespace mystl {
     void uninitialized_fill(ForwardIter first, ForwardIter last, const T &value)
     {
         mystl::__uninitialized_fill(first, last, value,
-                                    std::is_trivially_copy_assignable<
+                                    mystl::__is_uninit_copyable<
                                     typename iterator_traits<ForwardIter>::
                                     value_type>{});
     }
@@ -175,6 +195,7 @@ namespace mystl {
         {
             for (; first != cur; ++first)
             mystl::destroy(&*first);
+            throw;
         }
         return cur;
     }
@@ -183,7 +204,7 @@ namespace mystl {
     ForwardIter uninitialized_fill_n(ForwardIter first, Size n, const T& value)
     {
         return mystl::unchecked_uninit_fill_n(first, n, value, 
-                                                std::is_trivially_copy_assignable<
+                                                mystl::__is_uninit_copyable<
                                                 typename iterator_traits<ForwardIter>::
                                                 value_type>{});
     }
@@ -209,6 +230,7 @@ namespace mystl {
         }
         catch (...) {
             mystl::destroy(result, cur);
+            throw;
         }
 
         return cur;
@@ -218,7 +240,7 @@ namespace mystl {
     ForwardIter uninitialized_move(InputIter first, InputIter last, ForwardIter result)
     {
         return mystl::__uninitialized_move(first, last, result,
-                                           std::is_trivially_move_assignable<
+                                           mystl::__is_uninit_movable<
                                            typename iterator_traits<InputIter>::
                                            value_type>{});
     }
@@ -257,7 +279,7 @@ namespace mystl {
     ForwardIter uninitialized_move_n(InputIter first, Size n, ForwardIter result)
     {
         return mystl::unchecked_uninit_move_n(first, n, result,
-                                             std::is_trivially_move_assignable<
+                                             mystl::__is_uninit_movable<
                                              typename iterator_traits<InputIter>::
                                              value_type>{});
     }
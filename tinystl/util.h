@@ -3,6 +3,7 @@
 // pair
 
 #include <stddef.h>
+#include <utility>
 #include "typetraits.h"
 
 namespace mystl {
@@ -30,6 +31,16 @@ namespace mystl {
         return static_cast<T &&>(arg);
     }
 
+    // move_if_noexcept, 移动构造可能抛出异常且可以复制时返回左值引用, 以便改用复制
+    template <class T>
+    typename std::conditional<
+        !std::is_nothrow_move_constructible<T>::value && std::is_copy_constructible<T>::value,
+        const T&, T&&>::type
+    move_if_noexcept(T &arg) noexcept
+    {
+        return mystl::move(arg);
+    }
+
     // swap
     template <class Tp>
     void swap(Tp &lhs, Tp &rhs)
@@ -189,34 +200,18 @@ namespace mystl {
         {
         }
 
-        // copy assign for this pair
-        pair& operator=(const pair &rhs)
-        {
-            if (this != &rhs) {
-                first = rhs.first;
-                second = rhs.second;
-            }
-
-            return *this;
-        }
-
-        // move assign for this pair
-        pair& operator=(pair &&rhs)
-        {
-            if (this != &rhs) {
-                first = mystl::move(rhs.first);
-                second = mystl::move(rhs.second);
-            }
-
-            return *this;
-        }
+        // copy / move assign for this pair
+        // 使用默认版本, 成员都可平凡赋值时 pair 也可平凡赋值,
+        // copy / fill_n / uninitialized_copy 等可以走 memmove / memset 的特化版本
+        pair& operator=(const pair &rhs) = default;
+        pair& operator=(pair &&rhs) = default;
 
         // copy assign for other pair
         template <class Other1, class Other2>
         pair& operator=(const pair<Other1, Other2> &other)
         {
             first = other.first;
-            first = other.second;
+            second = other.second;
 
             return *this;
         }
@@ -292,4 +287,67 @@ namespace mystl {
     {
         return pair<Ty1, Ty2>(mystl::forward<Ty1>(first), mystl::forward<Ty2>(second));
     }
+
+    /*
+     * get
+     * 按下标取出 pair 的成员, 配合 std::tuple_size / std::tuple_element 支持结构化绑定
+     */
+    template <size_t I>
+    struct pair_get;
+
+    template <>
+    struct pair_get<0> {
+        template <class Ty1, class Ty2>
+        static constexpr Ty1& get(pair<Ty1, Ty2> &p) noexcept { return p.first; }
+
+        template <class Ty1, class Ty2>
+        static constexpr const Ty1& get(const pair<Ty1, Ty2> &p) noexcept { return p.first; }
+    };
+
+    template <>
+    struct pair_get<1> {
+        template <class Ty1, class Ty2>
+        static constexpr Ty2& get(pair<Ty1, Ty2> &p) noexcept { return p.second; }
+
+        template <class Ty1, class Ty2>
+        static constexpr const Ty2& get(const pair<Ty1, Ty2> &p) noexcept { return p.second; }
+    };
+
+    template <size_t I, class Ty1, class Ty2>
+    constexpr typename std::tuple_element<I, pair<Ty1, Ty2>>::type&
+    get(pair<Ty1, Ty2> &p) noexcept
+    {
+        return pair_get<I>::get(p);
+    }
+
+    template <size_t I, class Ty1, class Ty2>
+    constexpr const typename std::tuple_element<I, pair<Ty1, Ty2>>::type&
+    get(const pair<Ty1, Ty2> &p) noexcept
+    {
+        return pair_get<I>::get(p);
+    }
+
+    template <size_t I, class Ty1, class Ty2>
+    constexpr typename std::tuple_element<I, pair<Ty1, Ty2>>::type&&
+    get(pair<Ty1, Ty2> &&p) noexcept
+    {
+        return static_cast<typename std::tuple_element<I, pair<Ty1, Ty2>>::type&&>(
+            pair_get<I>::get(p));
+    }
+};
+
+// 结构化绑定所需的 tuple-like 接口
+namespace std {
+    template <class Ty1, class Ty2>
+    struct tuple_size<mystl::pair<Ty1, Ty2>> : public std::integral_constant<size_t, 2> {};
+
+    template <class Ty1, class Ty2>
+    struct tuple_element<0, mystl::pair<Ty1, Ty2>> {
+        typedef Ty1 type;
+    };
+
+    template <class Ty1, class Ty2>
+    struct tuple_element<1, mystl::pair<Ty1, Ty2>> {
+        typedef Ty2 type;
+    };
 };
\ No newline at end of file
@@ -0,0 +1,197 @@
+#pragma once
+
+/*
+ * 模板类 work_stealing_deque
+ * Chase-Lev 工作窃取双端队列: 拥有者线程在底部 push/pop, 其它线程在顶部 steal.
+ * 元素存放在可增长的环形数组中, 数组满时由拥有者换成两倍大小的新数组;
+ * 旧数组可能仍被窃取者读取, 留到析构时统一释放.
+ * 元素在窃取时会被并发读取, 因此 T 须是可平凡复制的类型 (通常是任务指针)
+ */
+
+#include <atomic>
+#include <new>
+#include <stdint.h>
+#include <type_traits>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "exceptdef.h"
+#include "util.h"
+
+#ifndef WORK_STEALING_DEQUE_INIT_SIZE
+#define WORK_STEALING_DEQUE_INIT_SIZE 64
+#endif
+
+namespace mystl {
+    template <class T>
+    class work_stealing_deque {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "work_stealing_deque<T> requires a trivially copyable T");
+
+    public:
+        typedef T          value_type;
+        typedef size_t     size_type;
+
+    private:
+        typedef ptrdiff_t  index_type;
+
+        // 环形数组, 容量为 2 的幂
+        struct ring {
+            std::atomic<T> *slots;
+            index_type      mask;
+            ring           *prev;  // 被替换下来的旧数组
+
+            T    get(index_type i) const noexcept { return slots[i & mask].load(std::memory_order_relaxed); }
+            void put(index_type i, T x) noexcept  { slots[i & mask].store(x, std::memory_order_relaxed); }
+        };
+
+        typedef mystl::allocator<ring>           ring_allocator;
+        typedef mystl::allocator<std::atomic<T>> slot_allocator;
+
+        alignas(MYSTL_CACHE_LINE_SIZE) std::atomic<index_type> top_;     // 窃取端
+        alignas(MYSTL_CACHE_LINE_SIZE) std::atomic<index_type> bottom_;  // 拥有者端
+        std::atomic<ring*>                                     ring_;
+
+    public:
+        explicit work_stealing_deque(size_type capacity = WORK_STEALING_DEQUE_INIT_SIZE)
+            : top_(0), bottom_(0), ring_(nullptr)
+        {
+            size_type cap = 1;
+            while (cap < capacity)
+                cap <<= 1;
+            ring_.store(create_ring(cap, nullptr), std::memory_order_relaxed);
+        }
+
+        work_stealing_deque(const work_stealing_deque&) = delete;
+        work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+        ~work_stealing_deque()
+        {
+            ring *r = ring_.load(std::memory_order_relaxed);
+            while (r != nullptr) {
+                ring *prev = r->prev;
+                destroy_ring(r);
+                r = prev;
+            }
+        }
+
+    public:
+        // 近似的元素个数
+        size_type size() const noexcept
+        {
+            const index_type b = bottom_.load(std::memory_order_relaxed);
+            const index_type t = top_.load(std::memory_order_relaxed);
+            return b > t ? static_cast<size_type>(b - t) : 0;
+        }
+        bool      empty() const noexcept { return size() == 0; }
+
+        // 以下只能由拥有者调用
+        void      push(T x);
+        bool      pop(T &out) noexcept;
+
+        // 任意线程均可调用, 与其它窃取者或拥有者竞争失败时返回 false
+        bool      steal(T &out) noexcept;
+
+    private:
+        ring*     create_ring(size_type cap, ring *prev);
+        void      destroy_ring(ring *r) noexcept;
+        ring*     grow(ring *r, index_type t, index_type b);
+    };
+
+    /*****************************************************************************************/
+
+    template <class T>
+    void work_stealing_deque<T>::push(T x)
+    {
+        const index_type b = bottom_.load(std::memory_order_relaxed);
+        const index_type t = top_.load(std::memory_order_acquire);
+        ring *r = ring_.load(std::memory_order_relaxed);
+        if (b - t > r->mask) {
+            r = grow(r, t, b);
+            ring_.store(r, std::memory_order_release);
+        }
+        r->put(b, x);
+        bottom_.store(b + 1, std::memory_order_release);
+    }
+
+    template <class T>
+    bool work_stealing_deque<T>::pop(T &out) noexcept
+    {
+        const index_type b = bottom_.load(std::memory_order_relaxed) - 1;
+        ring *r = ring_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_seq_cst);
+        index_type t = top_.load(std::memory_order_seq_cst);
+        if (t > b) {
+            // 已空
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        out = r->get(b);
+        if (t == b) {
+            // 最后一个元素, 与窃取者竞争
+            const bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                          std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    template <class T>
+    bool work_stealing_deque<T>::steal(T &out) noexcept
+    {
+        index_type t = top_.load(std::memory_order_seq_cst);
+        const index_type b = bottom_.load(std::memory_order_seq_cst);
+        if (t >= b)
+            return false;
+        ring *r = ring_.load(std::memory_order_acquire);
+        const T x = r->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed))
+            return false;
+        out = x;
+        return true;
+    }
+
+    /*****************************************************************************************/
+    // helper function
+
+    template <class T>
+    typename work_stealing_deque<T>::ring*
+    work_stealing_deque<T>::create_ring(size_type cap, ring *prev)
+    {
+        THROW_LENGTH_ERROR_IF(cap > static_cast<size_type>(PTRDIFF_MAX),
+                              "work_stealing_deque<T> too long");
+        ring *r = ring_allocator::allocate(1);
+        try {
+            r->slots = slot_allocator::allocate(cap);
+        }
+        catch (...) {
+            ring_allocator::deallocate(r, 1);
+            throw;
+        }
+        for (size_type i = 0; i < cap; ++i)
+            ::new (static_cast<void*>(r->slots + i)) std::atomic<T>();
+        r->mask = static_cast<index_type>(cap - 1);
+        r->prev = prev;
+        return r;
+    }
+
+    template <class T>
+    void work_stealing_deque<T>::destroy_ring(ring *r) noexcept
+    {
+        slot_allocator::deallocate(r->slots, static_cast<size_type>(r->mask) + 1);
+        ring_allocator::deallocate(r, 1);
+    }
+
+    // 换成两倍大小的数组, 复制 [t, b) 中的元素
+    template <class T>
+    typename work_stealing_deque<T>::ring*
+    work_stealing_deque<T>::grow(ring *r, index_type t, index_type b)
+    {
+        ring *bigger = create_ring((static_cast<size_type>(r->mask) + 1) << 1, r);
+        for (index_type i = t; i < b; ++i)
+            bigger->put(i, r->get(i));
+        return bigger;
+    }
+};